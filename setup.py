@@ -287,6 +287,8 @@ def get_extensions():
                 print('libpng include path: {0}'.format(png_include))
                 image_include += [png_include]
                 image_link_flags.append('png')
+                # The parallel PNG encoder calls zlib, a dependency of libpng
+                image_link_flags.append('z')
             else:
                 print('libpng installed version is less than 1.6.0, '
                       'disabling PNG support')
@@ -300,6 +302,7 @@ def get_extensions():
             image_library += [png_lib]
             image_include += [png_include]
             image_link_flags.append('libpng')
+            image_link_flags.append('zlib')
 
     # Locating libjpeg
     (jpeg_found, jpeg_conda,
@@ -0,0 +1,49 @@
+import argparse
+import itertools
+from timeit import default_timer as timer
+
+import torch
+import torchvision  # noqa: F401 (registers the torchvision ops)
+
+
+parser = argparse.ArgumentParser(description='Per-call overhead of the antialiased interpolation ops')
+parser.add_argument('--sizes', default='32,64,128', type=str,
+                    help='comma separated list of input sizes (default: 32,64,128)')
+parser.add_argument('--scale', default=0.5, type=float,
+                    help='output size / input size ratio (default: 0.5)')
+parser.add_argument('--iters', default=2000, type=int,
+                    help='number of calls per measurement (default: 2000)')
+parser.add_argument('--threads', default=1, type=int,
+                    help='number of intra-op threads (default: 1)')
+
+
+def bench(fn, inputs, iters):
+    # warm-up
+    for x, size in itertools.islice(itertools.cycle(inputs), 10):
+        fn(x, size, False)
+    start_time = timer()
+    for x, size in itertools.islice(itertools.cycle(inputs), iters):
+        fn(x, size, False)
+    return (timer() - start_time) / iters * 1.0e+6
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    torch.set_num_threads(args.threads)
+
+    ops = {
+        "linear": torch.ops.torchvision._interpolate_linear_aa,
+        "bicubic": torch.ops.torchvision._interpolate_bicubic_aa,
+    }
+
+    print("{:>8} {:>6} {:>14} {:>14}".format("filter", "size", "repeated (us)", "distinct (us)"))
+    for name, fn in ops.items():
+        for s in [int(v) for v in args.sizes.split(",")]:
+            x = torch.rand(1, 3, s, s)
+            out = max(int(s * args.scale), 1)
+            # Same geometry on every call: the weight tables are served from the cache
+            repeated = [(x, [out, out])]
+            # A new geometry on every call (more than the cache capacity): tables are recomputed
+            distinct = [(torch.rand(1, 3, s + i, s + i), [out, out]) for i in range(300)]
+            print("{:>8} {:>6} {:>14.2f} {:>14.2f}".format(
+                name, s, bench(fn, repeated, args.iters), bench(fn, distinct, args.iters)))
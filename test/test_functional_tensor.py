@@ -916,6 +916,107 @@ def test_resize_antialias(device, dt, size, interpolation):
     assert_equal(resized_tensor, resize_result)
 
 
+@pytest.mark.parametrize('size', [[96, 72], [96, 420], [420, 72]])
+@pytest.mark.parametrize('interpolation', [InterpolationMode.BOX, InterpolationMode.HAMMING, InterpolationMode.LANCZOS])
+def test_resize_antialias_pil_filters(size, interpolation):
+
+    torch.manual_seed(12)
+    script_fn = torch.jit.script(F.resize)
+    tensor, pil_img = _create_data(320, 290, device="cpu")
+
+    resized_tensor = F.resize(tensor, size=size, interpolation=interpolation, antialias=True)
+    resized_pil_img = F.resize(pil_img, size=size, interpolation=interpolation)
+
+    assert resized_tensor.size()[1:] == resized_pil_img.size[::-1]
+    _assert_approx_equal_tensor_to_pil(
+        resized_tensor.to(torch.float), resized_pil_img, tol=1.0, msg=f"{size}, {interpolation}"
+    )
+
+    resize_result = script_fn(tensor, size=size, interpolation=interpolation, antialias=True)
+    assert_equal(resized_tensor, resize_result)
+
+    with pytest.raises(ValueError, match=r"only supported with antialias=True"):
+        F.resize(tensor, size=size, interpolation=interpolation, antialias=False)
+
+
+@pytest.mark.parametrize('interpolation', [BILINEAR, BICUBIC])
+def test_resize_antialias_repeated_geometry(interpolation):
+    # The CPU kernel caches the weight tables per geometry: make sure that repeated calls,
+    # calls with another dtype and calls on other memory layouts still give the right results
+    torch.manual_seed(12)
+    tensor = torch.rand(2, 3, 64, 48, dtype=torch.float64)
+    expected = F.resize(tensor, size=[20, 30], interpolation=interpolation, antialias=True)
+
+    for _ in range(3):
+        out = F.resize(tensor, size=[20, 30], interpolation=interpolation, antialias=True)
+        assert_equal(out, expected)
+
+    out = F.resize(tensor.float(), size=[20, 30], interpolation=interpolation, antialias=True)
+    assert out.dtype == torch.float32
+    torch.testing.assert_close(out, expected.float(), rtol=1e-5, atol=1e-5)
+
+    out = F.resize(tensor[:, :, :, :32], size=[20, 30], interpolation=interpolation, antialias=True)
+    expected = F.resize(tensor[:, :, :, :32].contiguous(), size=[20, 30], interpolation=interpolation, antialias=True)
+    assert_equal(out, expected)
+
+
+@pytest.mark.parametrize('size', [[5, 7], [20, 11], [13, 13]])
+@pytest.mark.parametrize('op_name', [
+    '_interpolate_linear_aa', '_interpolate_bicubic_aa', '_interpolate_box_aa', '_interpolate_hamming_aa',
+    '_interpolate_lanczos_aa',
+])
+def test_resize_antialias_backward(size, op_name):
+    torch.manual_seed(12)
+    op = getattr(torch.ops.torchvision, op_name)
+    x = torch.rand(2, 3, 13, 9, dtype=torch.float64, requires_grad=True)
+
+    def fn(x):
+        return op(x, size, False)
+
+    assert torch.autograd.gradcheck(fn, (x,))
+
+    # channels last inputs give the same gradient
+    x_cl = x.detach().contiguous(memory_format=torch.channels_last).requires_grad_()
+    grad_out = torch.rand(2, 3, *size, dtype=torch.float64)
+    fn(x).backward(grad_out)
+    fn(x_cl).backward(grad_out)
+    torch.testing.assert_close(x.grad, x_cl.grad)
+
+
+@pytest.mark.parametrize('interpolation, antialias', [
+    (BILINEAR, False), (BILINEAR, True), (BICUBIC, True), (InterpolationMode.LANCZOS, True),
+])
+@pytest.mark.parametrize('size', [[24, 20], [70, 33]])
+@pytest.mark.parametrize('input_channels_last', [False, True])
+@pytest.mark.parametrize('channels_last', [False, True])
+def test_resized_crop_normalize(interpolation, antialias, size, input_channels_last, channels_last):
+    torch.manual_seed(12)
+    tensor = torch.randint(0, 256, (3, 60, 50), dtype=torch.uint8)
+    if input_channels_last:
+        # HWC image, passed as a CHW view
+        tensor = tensor.permute(1, 2, 0).contiguous().permute(2, 0, 1)
+    top, left, height, width = 5, 7, 41, 36
+    mean, std = [0.485, 0.456, 0.406], [0.229, 0.224, 0.225]
+
+    out = torch.ops.torchvision._resized_crop_normalize(
+        tensor, top, left, height, width, size, mean, std, interpolation.value, antialias, torch.float, channels_last
+    )
+    assert out.shape == (3, *size)
+    assert out.dtype == torch.float
+    assert out.permute(1, 2, 0).is_contiguous() == channels_last
+
+    expected = F.crop(tensor.float(), top, left, height, width)
+    expected = F.resize(expected, size, interpolation=interpolation, antialias=antialias)
+    expected = F.normalize(expected.clamp(0, 255) / 255, mean, std)
+    torch.testing.assert_close(out, expected, rtol=0, atol=1e-4)
+
+    out = torch.ops.torchvision._resized_crop_normalize(
+        tensor, top, left, height, width, size, mean, std, interpolation.value, antialias, torch.bfloat16, channels_last
+    )
+    assert out.dtype == torch.bfloat16
+    torch.testing.assert_close(out.float(), expected, rtol=1e-2, atol=1e-2)
+
+
 @needs_cuda
 @pytest.mark.parametrize('interpolation', [BILINEAR, BICUBIC])
 def test_assert_resize_antialias(interpolation):
@@ -13,8 +13,10 @@ from common_utils import get_tmp_dir, needs_cuda, cpu_only
 from _assert_utils import assert_equal
 
 from torchvision.io.image import (
-    decode_png, decode_jpeg, encode_jpeg, write_jpeg, decode_image, read_file,
-    encode_png, write_png, write_file, ImageReadMode, read_image)
+    decode_png, decode_jpeg, encode_jpeg, encode_jpeg_batch, write_jpeg, decode_image, read_file,
+    encode_png, write_png, write_file, ImageReadMode, read_image, read_image_batch, decode_jpeg_batch,
+    decode_image_batch, decode_jpeg_crop, decode_jpeg_out, decode_jpeg_raw, decode_png_out, decode_image_out,
+    get_decoded_shape, probe_image, probe_image_batch, crop_jpeg, transform_jpeg)
 
 IMAGE_ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "assets")
 FAKEDATA_DIR = os.path.join(IMAGE_ROOT, "fakedata")
@@ -86,6 +88,165 @@ def test_decode_jpeg(img_path, pil_mode, mode):
     assert abs_mean_diff < 2
 
 
+@pytest.mark.parametrize('img_path', [
+    pytest.param(jpeg_path, id=_get_safe_image_name(jpeg_path))
+    for jpeg_path in get_images(IMAGE_ROOT, ".jpg")
+])
+@pytest.mark.parametrize('scale', [1, 2, 3, 4, 8])
+def test_decode_jpeg_min_size(img_path, scale):
+    data = read_file(img_path)
+    full = decode_jpeg(data)
+    height, width = full.shape[-2:]
+    min_size = (height // scale, width // scale)
+
+    img = decode_jpeg(data, min_size=min_size)
+    assert img.shape[0] == full.shape[0]
+    assert img.shape[1] >= min_size[0] and img.shape[2] >= min_size[1]
+    if scale == 1:
+        assert_equal(img, full)
+    else:
+        resized = F.resize(full.float(), img.shape[-2:], antialias=True)
+        assert (img.float() - resized).abs().mean() < 4
+
+    with pytest.raises(ValueError, match="min_size is only supported when decoding on CPU"):
+        decode_jpeg(data, device='cuda', min_size=min_size)
+
+
+def test_decode_jpeg_max_scans():
+    img = read_image(next(get_images(ENCODE_JPEG, ".jpg")))
+    with Image.fromarray(img.permute(1, 2, 0).numpy()) as pil_img:
+        buf = io.BytesIO()
+        pil_img.save(buf, format="JPEG", quality=90, progressive=True)
+    data = torch.as_tensor(np.frombuffer(buf.getvalue(), dtype=np.uint8))
+    full = decode_jpeg(data)
+
+    # Each scan refines the image, up to the full decode
+    errors = []
+    for max_scans in (1, 2, 5, 100):
+        preview = decode_jpeg(data, max_scans=max_scans)
+        assert preview.shape == full.shape
+        errors.append((preview.float() - full.float()).abs().mean().item())
+    assert errors[0] > 0
+    assert errors == sorted(errors, reverse=True)
+    assert errors[-1] == 0
+
+    min_size = (full.shape[1] // 4, full.shape[2] // 4)
+    preview = decode_jpeg(data, min_size=min_size, max_scans=1)
+    assert preview.shape == decode_jpeg(data, min_size=min_size).shape
+
+    # Baseline images have a single scan
+    data = encode_jpeg(img, quality=90)
+    assert_equal(decode_jpeg(data, max_scans=1), decode_jpeg(data))
+
+    with pytest.raises(ValueError, match="max_scans is only supported when decoding on CPU"):
+        decode_jpeg(data, device='cuda', max_scans=1)
+
+
+@pytest.mark.parametrize('img_path', [
+    pytest.param(jpeg_path, id=_get_safe_image_name(jpeg_path))
+    for jpeg_path in get_images(IMAGE_ROOT, ".jpg")
+])
+@pytest.mark.parametrize('box', [(0, 0, 1.0, 1.0), (0.1, 0.2, 0.5, 0.3), (0.37, 0.51, 0.63, 0.49), (0.5, 0, 0.5, 1.0)])
+def test_decode_jpeg_crop(img_path, box):
+    data = read_file(img_path)
+    full = decode_jpeg(data)
+    height, width = full.shape[-2:]
+    top, left = int(box[0] * height), int(box[1] * width)
+    crop_height, crop_width = max(int(box[2] * height), 1), max(int(box[3] * width), 1)
+
+    img = decode_jpeg_crop(data, top, left, crop_height, crop_width)
+    expected = full[:, top:top + crop_height, left:left + crop_width]
+    assert img.shape == expected.shape
+    # Chroma upsampling at the borders of skipped iMCU rows may differ slightly
+    assert (img.float() - expected.float()).abs().mean() < 1
+
+    # the region is decoded downscaled, the same way as the whole image is
+    min_size = (crop_height // 2, crop_width // 2)
+    img = decode_jpeg_crop(data, top, left, crop_height, crop_width, min_size=min_size)
+    assert img.shape[1] >= min_size[0] and img.shape[2] >= min_size[1]
+    assert img.shape[1] <= crop_height and img.shape[2] <= crop_width
+
+    with pytest.raises(RuntimeError, match="is not contained in the image"):
+        decode_jpeg_crop(data, top, left, height + 1, crop_width)
+
+
+@pytest.mark.parametrize('img_path', [
+    pytest.param(path, id=_get_safe_image_name(path))
+    for path in list(get_images(IMAGE_ROOT, ".jpg")) + list(get_images(FAKEDATA_DIR, ".png"))
+])
+@pytest.mark.parametrize('mode', [ImageReadMode.UNCHANGED, ImageReadMode.GRAY, ImageReadMode.RGB])
+def test_decode_channels_last(img_path, mode):
+    data = read_file(img_path)
+    try:
+        expected = decode_image(data, mode=mode)
+    except RuntimeError:
+        pytest.xfail("Conversion not supported for this image")
+
+    assert expected.permute(1, 2, 0).is_contiguous()
+    img = decode_image(data, mode=mode, channels_last=False)
+    assert img.is_contiguous()
+    assert_equal(img, expected)
+
+    if img_path.endswith(".jpg"):
+        img = decode_jpeg(data, mode=mode, channels_last=False)
+        assert img.is_contiguous()
+        assert_equal(img, expected)
+
+        height, width = expected.shape[-2:]
+        img = decode_jpeg_crop(data, 1, 2, height - 3, width // 2, mode=mode, channels_last=False)
+        assert img.is_contiguous()
+        assert_equal(img, decode_jpeg_crop(data, 1, 2, height - 3, width // 2, mode=mode))
+    else:
+        img = decode_png(data, mode=mode, channels_last=False)
+        assert img.is_contiguous()
+        assert_equal(img, expected)
+
+
+@pytest.mark.parametrize('img_path', [
+    pytest.param(path, id=_get_safe_image_name(path))
+    for path in list(get_images(IMAGE_ROOT, ".jpg")) + list(get_images(FAKEDATA_DIR, ".png"))
+])
+@pytest.mark.parametrize('mode', [ImageReadMode.UNCHANGED, ImageReadMode.GRAY, ImageReadMode.RGB])
+def test_decode_out(img_path, mode):
+    data = read_file(img_path)
+    try:
+        expected = decode_image(data, mode=mode)
+    except RuntimeError:
+        pytest.xfail("Conversion not supported for this image")
+
+    shape = get_decoded_shape(data, mode=mode)
+    assert shape == list(expected.shape)
+
+    # slots of contiguous and channels last batches
+    for memory_format in (torch.contiguous_format, torch.channels_last):
+        batch = torch.zeros((2, *shape), dtype=torch.uint8).contiguous(memory_format=memory_format)
+        out = decode_image_out(data, batch[1], mode=mode)
+        assert out.data_ptr() == batch[1].data_ptr()
+        assert_equal(batch[1], expected)
+        assert batch[0].sum() == 0
+
+        out = torch.empty(shape, dtype=torch.uint8)
+        if img_path.endswith(".jpg"):
+            decode_jpeg_out(data, out, mode=mode)
+        else:
+            decode_png_out(data, out, mode=mode)
+        assert_equal(out, expected)
+
+    if img_path.endswith(".jpg"):
+        min_size = (shape[1] // 3, shape[2] // 3)
+        expected = decode_jpeg(data, mode=mode, min_size=min_size)
+        shape = get_decoded_shape(data, mode=mode, min_size=min_size)
+        assert shape == list(expected.shape)
+        out = decode_jpeg_out(data, torch.empty(shape, dtype=torch.uint8), mode=mode, min_size=min_size)
+        assert_equal(out, expected)
+
+    with pytest.raises(RuntimeError, match="Expected out to be a uint8 CPU tensor of shape"):
+        decode_image_out(data, torch.empty((shape[0], shape[1] + 1, shape[2]), dtype=torch.uint8), mode=mode)
+    with pytest.raises(RuntimeError, match="Expected out to be a uint8 CPU tensor of shape"):
+        decode_image_out(data, torch.empty((shape[0], shape[2], shape[1]), dtype=torch.uint8).transpose(1, 2),
+                         mode=mode)
+
+
 def test_decode_jpeg_errors():
     with pytest.raises(RuntimeError, match="Expected a non empty 1-dimensional tensor"):
         decode_jpeg(torch.empty((100, 1), dtype=torch.uint8))
@@ -118,6 +279,141 @@ def test_damaged_corrupt_images(img_path):
         decode_jpeg(data)
 
 
+@pytest.mark.parametrize('num_threads', [0, 1, 3])
+def test_decode_batch(num_threads):
+    jpeg_paths = sorted(get_images(IMAGE_ROOT, ".jpg"))
+    png_paths = sorted(get_images(FAKEDATA_DIR, ".png"))
+    jpeg_data = [read_file(path) for path in jpeg_paths]
+    corrupt_data = read_file(os.path.join(DAMAGED_JPEG, 'corrupt34.jpg'))
+
+    # A bad image is reported in place, the rest of the batch is still decoded
+    images, errors = decode_jpeg_batch(jpeg_data + [corrupt_data], num_threads=num_threads)
+    assert len(images) == len(errors) == len(jpeg_data) + 1
+    for data, img, error in zip(jpeg_data, images, errors):
+        assert error == ""
+        assert_equal(img, decode_jpeg(data))
+    assert images[-1].numel() == 0
+    assert "Image is incomplete or truncated" in errors[-1]
+
+    data = jpeg_data + [read_file(path) for path in png_paths]
+    images, errors = decode_image_batch(data, mode=ImageReadMode.RGB, num_threads=num_threads)
+    for d, img, error in zip(data, images, errors):
+        with Image.open(io.BytesIO(d.numpy().tobytes())) as pil_img:
+            is_cmyk = pil_img.mode == "CMYK"
+        if is_cmyk:
+            # libjpeg does not support the conversion
+            assert error != ""
+        else:
+            assert error == ""
+            assert_equal(img, decode_image(d, mode=ImageReadMode.RGB))
+
+    assert decode_image_batch([]) == ([], [])
+
+
+def test_probe_image():
+    paths = sorted(get_images(IMAGE_ROOT, ".jpg")) + sorted(get_images(FAKEDATA_DIR, ".png"))
+    data = [read_file(path) for path in paths]
+
+    for path, d in zip(paths, data):
+        info = probe_image(d)
+        with Image.open(path) as pil_img:
+            assert (info.width, info.height) == pil_img.size
+            assert info.progressive == bool(pil_img.info.get("progressive", False))
+            assert info.interlaced == bool(pil_img.info.get("interlace", False))
+            assert info.orientation == pil_img.getexif().get(0x0112, 1)
+        assert info.num_channels == get_decoded_shape(d)[0]
+        if path.endswith(".jpg"):
+            assert info.bit_depth == 8
+
+    not_an_image = torch.randint(0, 255, (100,), dtype=torch.uint8)
+    not_an_image[0] = 0
+    info, errors = probe_image_batch(data + [not_an_image])
+    assert info.shape == (len(data) + 1, 7)
+    for d, row, error in zip(data, info, errors):
+        assert error == ""
+        assert tuple(row.tolist()) == tuple(int(v) for v in probe_image(d))
+    assert (info[-1] == -1).all()
+    assert "Unsupported image file" in errors[-1]
+
+    with pytest.raises(RuntimeError, match="Image is incomplete or truncated"):
+        probe_image(data[0][:20])
+
+
+@pytest.mark.parametrize('subsampling, factors', [("444", (1, 1)), ("422", (1, 2)), ("420", (2, 2))])
+def test_decode_jpeg_raw(subsampling, factors):
+    img = read_image(next(get_images(ENCODE_JPEG, ".jpg")))
+    data = encode_jpeg(img, quality=90, subsampling=subsampling)
+    height, width = img.shape[-2:]
+
+    y, cb, cr = decode_jpeg_raw(data)
+    # The luma plane is what libjpeg returns for a grayscale decode
+    assert_equal(y, decode_jpeg(data, mode=ImageReadMode.GRAY)[0])
+    v, h = factors
+    expected_shape = ((height + v - 1) // v, (width + h - 1) // h)
+    assert cb.shape == cr.shape == expected_shape
+
+    if subsampling == "444":
+        # Chroma planes match the color conversion done by PIL, up to rounding
+        with Image.open(io.BytesIO(data.numpy().tobytes())) as pil_img:
+            pil_ycbcr = torch.from_numpy(np.array(pil_img.convert("YCbCr"))).permute(2, 0, 1)
+        assert (cb.float() - pil_ycbcr[1].float()).abs().mean() < 2
+        assert (cr.float() - pil_ycbcr[2].float()).abs().mean() < 2
+
+    gray = decode_jpeg_raw(encode_jpeg(img[:1]))
+    assert len(gray) == 1 and gray[0].shape == (height, width)
+
+
+@pytest.mark.parametrize('transform, expected_fn, trimmed', [
+    ("hflip", lambda img: img.flip(-1), (False, True)),
+    ("vflip", lambda img: img.flip(-2), (True, False)),
+    ("transpose", lambda img: img.transpose(-1, -2), (False, False)),
+    ("rot90", lambda img: img.rot90(-1, (-2, -1)), (True, False)),
+    ("rot180", lambda img: img.rot90(2, (-2, -1)), (True, True)),
+    ("rot270", lambda img: img.rot90(1, (-2, -1)), (False, True)),
+])
+def test_transform_jpeg(transform, expected_fn, trimmed):
+    img = read_image(next(get_images(ENCODE_JPEG, ".jpg")))
+    height, width = img.shape[-2:]
+    # Whole 4:2:0 iMCUs, so that nothing is trimmed
+    img = img[:, :height - height % 16, :width - width % 16]
+    data = encode_jpeg(img, quality=90)
+    # Luma only: the chroma upsampling of the decoder is not transform invariant
+    expected = expected_fn(decode_jpeg(data, mode=ImageReadMode.GRAY))
+
+    output = decode_jpeg(transform_jpeg(data, transform), mode=ImageReadMode.GRAY)
+    assert output.shape == expected.shape
+    # Flips are exact, transpositions only differ by the rounding of the IDCT
+    assert (output.float() - expected.float()).abs().max() <= 4
+
+    # Partial iMCUs that would move are trimmed
+    height, width = img.shape[-2:]
+    data = encode_jpeg(img[:, :height - 5, :width - 3], quality=90)
+    output = decode_jpeg(transform_jpeg(data, transform))
+    trimmed_height = height - 16 if trimmed[0] else height - 5
+    trimmed_width = width - 16 if trimmed[1] else width - 3
+    assert output.shape[-2:] == expected_fn(torch.empty(trimmed_height, trimmed_width)).shape
+
+    with pytest.raises(RuntimeError, match="transform should be one of"):
+        transform_jpeg(data, "rot45")
+
+
+def test_crop_jpeg():
+    img = read_image(next(get_images(ENCODE_JPEG, ".jpg")))
+    data = encode_jpeg(img, quality=90)
+    full = decode_jpeg(data, mode=ImageReadMode.GRAY)
+    height, width = full.shape[-2:]
+
+    top, left = height // 3, width // 5
+    output = decode_jpeg(crop_jpeg(data, top, left, height // 2, width // 2), mode=ImageReadMode.GRAY)
+    # The corner is aligned down to the 16x16 iMCUs of 4:2:0 images
+    aligned_top, aligned_left = top - top % 16, left - left % 16
+    expected = full[:, aligned_top:top + height // 2, aligned_left:left + width // 2]
+    assert_equal(output, expected)
+
+    with pytest.raises(RuntimeError, match="is not contained in the image"):
+        crop_jpeg(data, top, left, height, width)
+
+
 @pytest.mark.parametrize('img_path', [
     pytest.param(png_path, id=_get_safe_image_name(png_path))
     for png_path in get_images(FAKEDATA_DIR, ".png")
@@ -151,6 +447,42 @@ def test_decode_png_errors():
         decode_png(torch.randint(3, 5, (300,), dtype=torch.uint8))
 
 
+def test_decode_png_16_bits():
+    expected = torch.randint(0, 2 ** 16, (40, 50), dtype=torch.int32)
+    buf = io.BytesIO()
+    Image.fromarray(expected.numpy().astype(np.uint16)).save(buf, format="PNG")
+    data = torch.as_tensor(np.frombuffer(buf.getvalue(), dtype=np.uint8))
+
+    img = decode_png(data, allow_16_bits=True)
+    assert img.dtype == torch.int32
+    assert_equal(img, expected[None])
+    img = decode_png(data, mode=ImageReadMode.RGB, allow_16_bits=True, channels_last=False)
+    assert img.is_contiguous()
+    assert_equal(img, expected.expand(3, -1, -1))
+    img = decode_png(data, mode=ImageReadMode.GRAY_ALPHA, allow_16_bits=True)
+    assert_equal(img[1], torch.full_like(expected, 2 ** 16 - 1))
+
+    # Without allow_16_bits, the samples are reduced to 8 bits
+    img = decode_png(data)
+    assert img.dtype == torch.uint8
+    assert_equal(img, (expected[None] >> 8).to(torch.uint8))
+
+
+def test_decode_png_skip_checksums():
+    img = torch.randint(0, 256, (3, 32, 32), dtype=torch.uint8)
+    data = encode_png(img)
+    # The CRC is the last 4 bytes of the IDAT chunk, followed by the IEND chunk
+    idat_end = bytes(data.tolist()).index(b"IEND") - 4
+    corrupted = data.clone()
+    corrupted[idat_end - 1] ^= 0xFF
+    with pytest.raises(RuntimeError):
+        decode_png(corrupted)
+    assert_equal(decode_png(corrupted, skip_checksums=True), img)
+
+    with pytest.raises(RuntimeError):
+        decode_png(data[:len(data) // 2])
+
+
 @pytest.mark.parametrize('img_path', [
     pytest.param(png_path, id=_get_safe_image_name(png_path))
     for png_path in get_images(IMAGE_DIR, ".png")
@@ -184,6 +516,46 @@ def test_encode_png_errors():
         encode_png(torch.empty((5, 100, 100), dtype=torch.uint8))
 
 
+@pytest.mark.parametrize('num_threads', [0, 1, 3])
+@pytest.mark.parametrize('filter, strategy', [
+    ("default", "default"),
+    ("none", "huffman_only"),
+    ("sub", "rle"),
+    ("up", "fixed"),
+    ("avg", "filtered"),
+    ("paeth", "default"),
+    ("adaptive", "default"),
+])
+def test_encode_png_options(filter, strategy, num_threads):
+    # Large enough to be split into several bands
+    img = torch.arange(3 * 700 * 500, dtype=torch.int64).reshape(3, 700, 500)
+    img = (img % 251 + img // 5000).to(torch.uint8)
+    encoded = encode_png(img, filter=filter, strategy=strategy, num_threads=num_threads)
+    assert_equal(decode_png(encoded), img)
+    with Image.open(io.BytesIO(encoded.numpy().tobytes())) as pil_img:
+        assert_equal(F.pil_to_tensor(pil_img), img)
+
+    with pytest.raises(RuntimeError, match="filter should be one of"):
+        encode_png(img, filter="bad")
+    with pytest.raises(RuntimeError, match="strategy should be one of"):
+        encode_png(img, strategy="bad")
+
+
+@pytest.mark.parametrize('shape', [(3, 1, 1), (1, 64, 48), (3, 256, 320)])
+def test_encode_output_buffer(shape):
+    # Noise does not compress: the output buffers outgrow their size estimate
+    torch.manual_seed(0)
+    img = torch.randint(0, 256, shape, dtype=torch.uint8)
+
+    encoded_png = encode_png(img, compression_level=0)
+    assert encoded_png.dim() == 1 and encoded_png.is_contiguous()
+    assert_equal(decode_png(encoded_png), img)
+
+    encoded_jpeg = encode_jpeg(img, quality=100)
+    assert encoded_jpeg.dim() == 1 and encoded_jpeg.is_contiguous()
+    assert decode_jpeg(encoded_jpeg).shape == img.shape
+
+
 @pytest.mark.parametrize('img_path', [
     pytest.param(png_path, id=_get_safe_image_name(png_path))
     for png_path in get_images(IMAGE_DIR, ".png")
@@ -219,6 +591,44 @@ def test_read_file():
         read_file('tst')
 
 
+def test_read_file_mmap():
+    with get_tmp_dir() as d:
+        fname, content = '日本語(Japanese).bin', b'TorchVision\211\n'
+        fpath = os.path.join(d, fname)
+        with open(fpath, 'wb') as f:
+            f.write(content)
+
+        data = read_file(fpath, mmap=True)
+        expected = torch.tensor(list(content), dtype=torch.uint8)
+        assert_equal(data, expected)
+        assert_equal(data, read_file(fpath))
+
+        # Writes go to a private copy of the pages, not to the file
+        data.add_(1)
+        assert_equal(data, expected + 1)
+        assert_equal(read_file(fpath), expected)
+        # Release the mapping before the file is removed
+        del data
+
+    with pytest.raises(RuntimeError, match="No such file or directory: 'tst'"):
+        read_file('tst', mmap=True)
+
+
+def test_read_image_batch():
+    paths = sorted(get_images(IMAGE_ROOT, ".jpg")) + sorted(get_images(FAKEDATA_DIR, ".png"))
+    for path in paths:
+        assert_equal(read_image(path, mmap=True), decode_image(read_file(path)))
+
+    for mmap in (False, True):
+        images, errors = read_image_batch(paths + ['tst'], mode=ImageReadMode.GRAY, num_threads=3, mmap=mmap)
+        assert len(images) == len(errors) == len(paths) + 1
+        for path, img, error in zip(paths, images, errors):
+            assert error == ""
+            assert_equal(img, decode_image(read_file(path), mode=ImageReadMode.GRAY))
+        assert images[-1].numel() == 0
+        assert "No such file or directory: 'tst'" in errors[-1]
+
+
 def test_read_file_non_ascii():
     with get_tmp_dir() as d:
         fname, content = '日本語(Japanese).bin', b'TorchVision\211\n'
@@ -419,6 +829,53 @@ def test_encode_jpeg(img_path):
         assert_equal(encoded_jpeg_torch, encoded_jpeg_pil)
 
 
+@cpu_only
+@_collect_if(cond=not IS_WINDOWS)
+@pytest.mark.parametrize('img_path', [
+    pytest.param(jpeg_path, id=_get_safe_image_name(jpeg_path))
+    for jpeg_path in get_images(ENCODE_JPEG, ".jpg")
+])
+@pytest.mark.parametrize('subsampling, pil_subsampling', [("444", 0), ("422", 1), ("420", 2)])
+@pytest.mark.parametrize('optimize_coding', [False, True])
+def test_encode_jpeg_options(img_path, subsampling, pil_subsampling, optimize_coding):
+    img = read_image(img_path)
+
+    pil_img = F.to_pil_image(img)
+    buf = io.BytesIO()
+    pil_img.save(buf, format='JPEG', quality=90, subsampling=pil_subsampling, optimize=optimize_coding)
+    encoded_jpeg_pil = torch.as_tensor(np.frombuffer(buf.getvalue(), dtype=np.uint8))
+
+    # Planar, channels last and arbitrary strides inputs are all read in place
+    hwc = img.permute(1, 2, 0).contiguous()
+    padded = torch.zeros((img.shape[0], img.shape[1], img.shape[2] + 3), dtype=torch.uint8)
+    padded[:, :, :img.shape[2]] = img
+    for src_img in [img.contiguous(), hwc.permute(2, 0, 1), padded[:, :, :img.shape[2]]]:
+        encoded_jpeg_torch = encode_jpeg(src_img, quality=90, subsampling=subsampling,
+                                         optimize_coding=optimize_coding)
+        assert_equal(encoded_jpeg_torch, encoded_jpeg_pil)
+
+
+@cpu_only
+@pytest.mark.parametrize('dct_method', ["islow", "ifast", "float"])
+def test_encode_jpeg_batch(dct_method):
+    imgs = [read_image(path) for path in sorted(get_images(ENCODE_JPEG, ".jpg"))]
+    imgs.append(torch.empty((5, 10, 10), dtype=torch.uint8))
+
+    outputs, errors = encode_jpeg_batch(imgs, quality=80, dct_method=dct_method, num_threads=3)
+    assert len(outputs) == len(errors) == len(imgs)
+    for img, output, error in zip(imgs[:-1], outputs, errors):
+        assert error == ""
+        assert_equal(output, encode_jpeg(img, quality=80, dct_method=dct_method))
+        assert (decode_jpeg(output).float() - img.float()).abs().mean() < 5
+    assert outputs[-1].numel() == 0
+    assert "The number of channels should be 1 or 3, got: 5" in errors[-1]
+
+    with pytest.raises(RuntimeError, match="dct_method should be one of"):
+        encode_jpeg(imgs[0], dct_method="bad")
+    with pytest.raises(RuntimeError, match="subsampling should be one of"):
+        encode_jpeg(imgs[0], subsampling="bad")
+
+
 @cpu_only
 @_collect_if(cond=not IS_WINDOWS)
 @pytest.mark.parametrize('img_path', [
@@ -66,6 +66,28 @@ class Tester(unittest.TestCase):
         with self.assertRaises(TypeError):
             out = transform(image, targets)  # noqa: F841
 
+    def test_transform_batched_resize(self):
+        transform = GeneralizedRCNNTransform(300, 500, torch.zeros(3), torch.ones(3), batched_resize=True)
+        transform.eval()
+        images = [torch.rand(3, 200, 300), torch.rand(3, 211, 157), torch.rand(3, 480, 97)]
+        targets = [{'boxes': torch.rand(3, 4), 'masks': torch.randint(0, 2, (3, ) + img.shape[-2:], dtype=torch.uint8)}
+                   for img in images]
+
+        self.assertTrue(transform._use_batched_resize(images))
+        out_images, out_targets = transform(images, copy.deepcopy(targets))
+
+        # reference: resize each image separately, then pad them into a batch
+        reference = GeneralizedRCNNTransform(300, 500, torch.zeros(3), torch.ones(3))
+        reference.eval()
+        self.assertFalse(reference._use_batched_resize(images))
+        expected_images, expected_targets = reference(images, copy.deepcopy(targets))
+
+        self.assertEqual(out_images.image_sizes, expected_images.image_sizes)
+        torch.testing.assert_close(out_images.tensors, expected_images.tensors, rtol=0, atol=1e-5)
+        for out, expected in zip(out_targets, expected_targets):
+            assert_equal(out['boxes'], expected['boxes'])
+            assert_equal(out['masks'], expected['masks'])
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -836,6 +836,113 @@ class TestVideoReader(unittest.TestCase):
                         delta=0.1 * asample_rate.item(),
                     )
 
+    @PY39_SKIP
+    def test_read_video_from_file_num_threads(self):
+        """
+        Test the case when the codec decodes with several threads, the frames
+        must be the same as the single-threaded ones
+        """
+        args = (
+            seek_frame_margin,
+            0,  # getPtsOnly
+            1,  # readVideoStream
+            0, 0, 0, 0,  # width, height, minDimension, maxDimension
+            0, -1,  # videoStartPts, videoEndPts
+            0, 1,  # videoTimeBaseNum, videoTimeBaseDen
+            0,  # readAudioStream
+            0, 0,  # samples, channels
+            0, -1,  # audioStartPts, audioEndPts
+            0, 1,  # audioTimeBaseNum, audioTimeBaseDen
+        )
+        for test_video in test_videos:
+            full_path = os.path.join(VIDEO_DIR, test_video)
+            ref_result = torch.ops.video_reader.read_video_from_file(full_path, *args)
+            for num_threads, thread_type in [(0, "auto"), (4, "frame"), (4, "slice")]:
+                tv_result = torch.ops.video_reader.read_video_from_file(
+                    full_path, *args, numThreads=num_threads, threadType=thread_type
+                )
+                assert_equal(tv_result[0], ref_result[0])
+                assert_equal(tv_result[1], ref_result[1])
+
+        full_path = os.path.join(VIDEO_DIR, next(iter(test_videos)))
+        with self.assertRaisesRegex(RuntimeError, "threadType"):
+            torch.ops.video_reader.read_video_from_file(full_path, *args, threadType="pixel")
+
+    @PY39_SKIP
+    def test_read_video_from_file_packet_index(self):
+        """
+        Test the case when decoder seeks with a packet index, the frames in range
+        must be the same as the ones found by seeking with a margin. The index of
+        another file is ignored
+        """
+        other_index = None
+        for test_video in test_videos:
+            full_path = os.path.join(VIDEO_DIR, test_video)
+            packet_index = torch.ops.video_reader.build_packet_index_from_file(full_path)
+            self.assertEqual(packet_index.dtype, torch.uint8)
+            self.assertGreater(packet_index.numel(), 0)
+
+            vframe_pts, _, info = io._read_video_timestamps_from_file(full_path)
+            timebase = info.video_timebase
+            start, end = vframe_pts[len(vframe_pts) // 2], vframe_pts[-1]
+            args = (
+                seek_frame_margin,
+                0,  # getPtsOnly
+                1,  # readVideoStream
+                0, 0, 0, 0,  # width, height, minDimension, maxDimension
+                start, end,  # videoStartPts, videoEndPts
+                timebase.numerator, timebase.denominator,
+                0,  # readAudioStream
+                0, 0,  # samples, channels
+                0, -1,  # audioStartPts, audioEndPts
+                0, 1,  # audioTimeBaseNum, audioTimeBaseDen
+            )
+            ref_result = torch.ops.video_reader.read_video_from_file(full_path, *args)
+            tv_result = torch.ops.video_reader.read_video_from_file(full_path, *args, packetIndex=packet_index)
+            assert_equal(tv_result[0], ref_result[0])
+            assert_equal(tv_result[1], ref_result[1])
+
+            if other_index is not None:
+                tv_result = torch.ops.video_reader.read_video_from_file(full_path, *args, packetIndex=other_index)
+                assert_equal(tv_result[0], ref_result[0])
+                assert_equal(tv_result[1], ref_result[1])
+            other_index = packet_index
+
+        with self.assertRaisesRegex(RuntimeError, "Invalid packet index"):
+            torch.ops.video_reader.read_video_from_file(
+                full_path, *args, packetIndex=torch.zeros(16, dtype=torch.uint8)
+            )
+
+    @PY39_SKIP
+    def test_read_video_from_memory_packet_index(self):
+        """
+        Test the case when decoder reads data in memory and seeks with the packet
+        index of the file holding the same data
+        """
+        for test_video in test_videos:
+            full_path, video_tensor = _get_video_tensor(VIDEO_DIR, test_video)
+            packet_index = torch.ops.video_reader.build_packet_index_from_file(full_path)
+
+            vframe_pts, _, info = io._read_video_timestamps_from_file(full_path)
+            timebase = info.video_timebase
+            start, end = vframe_pts[len(vframe_pts) // 2], vframe_pts[-1]
+            args = (
+                seek_frame_margin,
+                0,  # getPtsOnly
+                1,  # readVideoStream
+                0, 0, 0, 0,  # width, height, minDimension, maxDimension
+                start, end,  # videoStartPts, videoEndPts
+                timebase.numerator, timebase.denominator,
+                0,  # readAudioStream
+                0, 0,  # samples, channels
+                0, -1,  # audioStartPts, audioEndPts
+                0, 1,  # audioTimeBaseNum, audioTimeBaseDen
+            )
+            ref_result = torch.ops.video_reader.read_video_from_file(full_path, *args)
+            tv_result = torch.ops.video_reader.read_video_from_memory(video_tensor, *args, packetIndex=packet_index)
+            assert_equal(tv_result[0], ref_result[0])
+            assert_equal(tv_result[1], ref_result[1])
+
     @PY39_SKIP
     def test_compare_read_video_from_memory_and_file(self):
         """
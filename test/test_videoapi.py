@@ -187,6 +187,49 @@ class TestVideoApi(unittest.TestCase):
                 ub = duration / 2 + 1 / md[stream]["fps"][0]
                 self.assertTrue((lb <= frame["pts"]) & (ub >= frame["pts"]))
 
+    def test_seek_repeated(self):
+        for test_video, config in test_videos.items():
+            full_path = os.path.join(VIDEO_DIR, test_video)
+
+            stream = "video"
+            md = VideoReader(full_path, stream).get_metadata()
+            duration = md[stream]["duration"][0]
+            if duration is None:
+                continue
+
+            seeks = [duration / 2, duration / 4, duration / 2, 0]
+            expected = [next(VideoReader(full_path, stream).seek(ts)) for ts in seeks]
+
+            # seeking again and again, in the middle of the decoding, gives the
+            # frames of freshly opened readers
+            video_reader = VideoReader(full_path, stream)
+            next(video_reader)
+            for ts, expected_frame in zip(seeks, expected):
+                frame = next(video_reader.seek(ts))
+                next(video_reader)
+                self.assertEqual(frame["pts"], expected_frame["pts"])
+                self.assertTrue(frame["data"].equal(expected_frame["data"]))
+
+    def test_seek_packet_index(self):
+        for test_video, config in test_videos.items():
+            full_path = os.path.join(VIDEO_DIR, test_video)
+
+            stream = "video"
+            packet_index = torchvision.io._build_packet_index_from_file(full_path)
+            md = VideoReader(full_path, stream).get_metadata()
+            duration = md[stream]["duration"][0]
+            if duration is None:
+                continue
+
+            # seeking with the index of the file gives the same frames as without it
+            video_reader = VideoReader(full_path, stream)
+            indexed_reader = VideoReader(full_path, stream, packet_index=packet_index)
+            for ts in [duration / 2, duration / 4, 0]:
+                frame = next(video_reader.seek(ts))
+                indexed_frame = next(indexed_reader.seek(ts))
+                self.assertEqual(indexed_frame["pts"], frame["pts"])
+                self.assertTrue(indexed_frame["data"].equal(frame["data"]))
+
     def test_fate_suite(self):
         video_path = fate("sub/MovText_capability_tester.mp4", VIDEO_DIR)
         vr = VideoReader(video_path)
@@ -0,0 +1,80 @@
+import argparse
+import glob
+import os
+from timeit import default_timer as timer
+
+import torch
+import torchvision  # noqa: F401 (registers the video_reader ops)
+
+try:
+    import av
+except ImportError:
+    av = None
+
+
+parser = argparse.ArgumentParser(description='Video decoding throughput for a range of codec thread counts')
+parser.add_argument('files', nargs='*', type=str,
+                    help='videos to decode (default: the videos of test/assets/videos)')
+parser.add_argument('--threads', default='1,2,4,0', type=str,
+                    help='comma separated list of codec thread counts, 0 is one per core (default: 1,2,4,0)')
+parser.add_argument('--thread-types', default='frame,slice,auto', type=str,
+                    help='comma separated list of codec threading modes (default: frame,slice,auto)')
+parser.add_argument('--iters', default=3, type=int,
+                    help='number of decodes per measurement, the fastest one is reported (default: 3)')
+
+
+def codec_name(path):
+    if av is None:
+        return "?"
+    with av.open(path) as container:
+        return container.streams.video[0].codec_context.name if container.streams.video else "?"
+
+
+def bench(path, num_threads, thread_type, iters):
+    best, num_frames = float("inf"), 0
+    for _ in range(iters):
+        start_time = timer()
+        result = torch.ops.video_reader.read_video_from_file(
+            path,
+            0,  # seekFrameMargin
+            0,  # getPtsOnly
+            1,  # readVideoStream
+            0, 0, 0, 0,  # width, height, minDimension, maxDimension
+            0, -1,  # videoStartPts, videoEndPts
+            0, 1,  # videoTimeBaseNum, videoTimeBaseDen
+            0,  # readAudioStream
+            0, 0,  # samples, channels
+            0, -1,  # audioStartPts, audioEndPts
+            0, 1,  # audioTimeBaseNum, audioTimeBaseDen
+            numThreads=num_threads,
+            threadType=thread_type,
+        )
+        best = min(best, timer() - start_time)
+        num_frames = result[1].numel()
+    return num_frames / best
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    files = args.files
+    if not files:
+        files = sorted(glob.glob(os.path.join(os.path.dirname(os.path.abspath(__file__)), "assets", "videos", "*")))
+    threads = [int(v) for v in args.threads.split(",")]
+    thread_types = args.thread_types.split(",")
+
+    print("{:>32} {:>8} {:>7} {:>8} {:>10} {:>8}".format("file", "codec", "type", "threads", "fps", "speedup"))
+    for path in files:
+        codec = codec_name(path)
+        baseline = None
+        for thread_type in thread_types:
+            for num_threads in threads:
+                try:
+                    fps = bench(path, num_threads, thread_type, args.iters)
+                except RuntimeError as e:
+                    print("{:>32} skipped: {}".format(os.path.basename(path)[-32:], e))
+                    break
+                if baseline is None:
+                    baseline = fps
+                speedup = fps / baseline if baseline else 0.0
+                print("{:>32} {:>8} {:>7} {:>8} {:>10.1f} {:>7.2f}x".format(
+                    os.path.basename(path)[-32:], codec, thread_type, num_threads, fps, speedup))
@@ -0,0 +1,147 @@
+#include "async_decoder.h"
+#include <c10/util/Logging.h>
+#include "sync_decoder.h"
+
+namespace ffmpeg {
+
+namespace {
+size_t payloadSize(const DecoderOutputMessage& msg) {
+  return msg.payload ? msg.payload->length() : 0;
+}
+} // namespace
+
+AsyncDecoder::~AsyncDecoder() {
+  stop();
+}
+
+bool AsyncDecoder::init(
+    const DecoderParameters& params,
+    DecoderInCallback&& in,
+    std::vector<DecoderMetadata>* metadata) {
+  // the decoding thread of the previous input must not outlive it
+  stop();
+  return Decoder::init(params, std::move(in), metadata);
+}
+
+bool AsyncDecoder::seek(long startOffset, long endOffset) {
+  // the decoding thread reads the input, it restarts on the next decode call
+  stop();
+  return Decoder::seek(startOffset, endOffset);
+}
+
+void AsyncDecoder::shutdown() {
+  stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    queueBytes_ = 0;
+  }
+  Decoder::shutdown();
+}
+
+void AsyncDecoder::interrupt() {
+  Decoder::interrupt();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  consumed_.notify_all();
+}
+
+std::unique_ptr<ByteStorage> AsyncDecoder::createByteStorage(size_t n) {
+  return std::make_unique<SyncDecoder::AVByteStorage>(n, pool_);
+}
+
+void AsyncDecoder::onInit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queue_.clear();
+  queueBytes_ = 0;
+  stop_ = false;
+  done_ = false;
+  status_ = 0;
+}
+
+void AsyncDecoder::run() {
+  int result;
+  for (;;) {
+    result = getFrame(params_.timeoutMs);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // no frames within the timeout is not an error for the decoding thread
+    if (stop_ || (result != 0 && result != ETIMEDOUT)) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  done_ = true;
+  status_ = result == 0 || result == ETIMEDOUT ? EINTR : result;
+  produced_.notify_all();
+}
+
+void AsyncDecoder::stop() {
+  Decoder::interrupt();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  consumed_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!done_) {
+    done_ = true;
+    status_ = EINTR;
+  }
+}
+
+int AsyncDecoder::decode(DecoderOutputMessage* out, uint64_t timeoutMs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!worker_.joinable() && !done_) {
+    // started on the first call rather than in onInit, as init seeks the
+    // input afterwards
+    worker_ = std::thread([this]() { run(); });
+  }
+
+  if (!produced_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+        return !queue_.empty() || done_;
+      })) {
+    LOG(INFO) << "Queue is empty";
+    return ETIMEDOUT;
+  }
+  if (queue_.empty()) {
+    return status_;
+  }
+
+  *out = std::move(queue_.front());
+  queue_.pop_front();
+  queueBytes_ -= payloadSize(*out);
+  consumed_.notify_one();
+  return 0;
+}
+
+void AsyncDecoder::push(DecoderOutputMessage&& buffer) {
+  const size_t bytes = payloadSize(buffer);
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto hasRoom = [this, bytes]() {
+    return stop_ || queue_.empty() ||
+        queueBytes_ + bytes <= params_.cacheSize;
+  };
+  const auto timeout = std::chrono::milliseconds(params_.cacheTimeoutMs);
+  while (!consumed_.wait_for(lock, timeout, hasRoom)) {
+    if (params_.enforceCacheSize) {
+      VLOG(1) << "uuid=" << params_.loggingUuid
+              << " cache is full, dropping frame, pts=" << buffer.header.pts;
+      return;
+    }
+  }
+  if (stop_) {
+    return;
+  }
+
+  queueBytes_ += bytes;
+  queue_.push_back(std::move(buffer));
+  produced_.notify_one();
+}
+} // namespace ffmpeg
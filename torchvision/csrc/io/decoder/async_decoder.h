@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "byte_storage_pool.h"
+#include "decoder.h"
+
+namespace ffmpeg {
+
+/**
+ * Class uses FFMPEG library to decode media streams in a background thread.
+ * Decoded frames are buffered in a bounded queue, so that the caller of
+ * decode() processes a frame while the next ones get decoded.
+ * The queue holds up to DecoderParameters::cacheSize bytes of payload, and
+ * always accepts at least one frame. When it is full the decoding thread waits
+ * for the caller; after cacheTimeoutMs the frame gets dropped if
+ * enforceCacheSize is set, otherwise the thread keeps waiting.
+ */
+class AsyncDecoder : public Decoder {
+ public:
+  ~AsyncDecoder() override;
+
+  // MediaDecoder overrides
+  bool init(
+      const DecoderParameters& params,
+      DecoderInCallback&& in,
+      std::vector<DecoderMetadata>* metadata) override;
+  int decode(DecoderOutputMessage* out, uint64_t timeoutMs) override;
+  void shutdown() override;
+  void interrupt() override;
+  bool seek(long startOffset, long endOffset) override;
+
+ private:
+  void push(DecoderOutputMessage&& buffer) override;
+  void onInit() override;
+  std::unique_ptr<ByteStorage> createByteStorage(size_t n) override;
+
+  // decoding thread body
+  void run();
+  // stops and joins the decoding thread
+  void stop();
+
+ private:
+  std::thread worker_;
+  std::mutex mutex_;
+  // signaled when a frame is queued or the decoding thread is done
+  std::condition_variable produced_;
+  // signaled when a frame is dequeued or the decoding thread must stop
+  std::condition_variable consumed_;
+  std::deque<DecoderOutputMessage> queue_;
+  size_t queueBytes_{0};
+  bool stop_{false};
+  bool done_{false};
+  // result of the decoding thread: ENODATA on EOF, or an error
+  int status_{0};
+  // payload buffers, recycled once the caller releases the messages
+  std::shared_ptr<ByteStoragePool> pool_{std::make_shared<ByteStoragePool>()};
+};
+} // namespace ffmpeg
@@ -0,0 +1,117 @@
+#include <c10/util/Logging.h>
+#include <gtest/gtest.h>
+#include "async_decoder.h"
+#include "memory_buffer.h"
+#include "sync_decoder.h"
+
+using namespace ffmpeg;
+
+namespace {
+const std::string kVideo = "pytorch/vision/test/assets/videos/R6llTwEh07w.mp4";
+
+std::vector<uint8_t> readFile(const std::string& name) {
+  FILE* f = fopen(name.c_str(), "rb");
+  CHECK(f != nullptr);
+  fseek(f, 0, SEEK_END);
+  std::vector<uint8_t> buffer(ftell(f));
+  rewind(f);
+  CHECK_EQ(buffer.size(), fread(buffer.data(), 1, buffer.size(), f));
+  fclose(f);
+  return buffer;
+}
+
+DecoderParameters getParams() {
+  DecoderParameters params;
+  params.timeoutMs = 10000;
+  params.startOffset = 1000000;
+  params.endOffset = 3000000;
+  params.seekAccuracy = 100000;
+  params.formats = {MediaFormat(), MediaFormat(0)};
+  params.uri = kVideo;
+  return params;
+}
+
+std::vector<long> decodePts(MediaDecoder& decoder) {
+  std::vector<long> pts;
+  DecoderOutputMessage out;
+  while (0 == decoder.decode(&out, 10000)) {
+    pts.push_back(out.header.pts);
+  }
+  return pts;
+}
+} // namespace
+
+TEST(AsyncDecoder, TestSameFramesAsSyncDecoder) {
+  auto params = getParams();
+  // room for a few frames
+  params.cacheSize = 8 * 1024 * 1024;
+
+  SyncDecoder syncDecoder;
+  CHECK(syncDecoder.init(params, nullptr, nullptr));
+  const auto expected = decodePts(syncDecoder);
+  syncDecoder.shutdown();
+
+  AsyncDecoder asyncDecoder;
+  CHECK(asyncDecoder.init(params, nullptr, nullptr));
+  EXPECT_EQ(decodePts(asyncDecoder), expected);
+  asyncDecoder.shutdown();
+  EXPECT_FALSE(expected.empty());
+}
+
+TEST(AsyncDecoder, TestMemoryBufferAndReinit) {
+  auto params = getParams();
+  params.uri.clear();
+  const auto buffer = readFile(kVideo);
+
+  AsyncDecoder decoder;
+  std::vector<long> first;
+  for (int i = 0; i < 2; ++i) {
+    CHECK(decoder.init(
+        params,
+        MemoryBuffer::getCallback(buffer.data(), buffer.size()),
+        nullptr));
+    const auto pts = decodePts(decoder);
+    if (i == 0) {
+      first = pts;
+    } else {
+      EXPECT_EQ(pts, first);
+    }
+  }
+  decoder.shutdown();
+}
+
+TEST(AsyncDecoder, TestEnforceCacheSizeDropsFrames) {
+  auto params = getParams();
+  params.formats = {MediaFormat(0)};
+  params.cacheSize = 1;
+  params.cacheTimeoutMs = 1;
+  params.enforceCacheSize = true;
+
+  SyncDecoder syncDecoder;
+  CHECK(syncDecoder.init(params, nullptr, nullptr));
+  const auto all = decodePts(syncDecoder);
+  syncDecoder.shutdown();
+
+  AsyncDecoder decoder;
+  CHECK(decoder.init(params, nullptr, nullptr));
+  std::vector<long> pts;
+  DecoderOutputMessage out;
+  while (0 == decoder.decode(&out, 10000)) {
+    pts.push_back(out.header.pts);
+    // slow consumer
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  decoder.shutdown();
+  EXPECT_LT(pts.size(), all.size());
+}
+
+TEST(AsyncDecoder, TestShutdownWhileDecoding) {
+  auto params = getParams();
+  params.endOffset = -1;
+  AsyncDecoder decoder;
+  CHECK(decoder.init(params, nullptr, nullptr));
+  DecoderOutputMessage out;
+  EXPECT_EQ(0, decoder.decode(&out, 10000));
+  // the decoding thread is blocked on the full queue
+  decoder.shutdown();
+}
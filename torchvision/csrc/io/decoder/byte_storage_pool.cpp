@@ -0,0 +1,71 @@
+#include "byte_storage_pool.h"
+#include <c10/util/Logging.h>
+
+namespace ffmpeg {
+
+namespace {
+// the smallest class is 4KB
+const size_t kMinClassBits = 12;
+// more buffers of a class are freed rather than cached, a few are enough to
+// cover the frames of every stream in flight
+const size_t kMaxFreePerClass = 4;
+} // namespace
+
+ByteStoragePool::~ByteStoragePool() {
+  for (auto& buffers : free_) {
+    for (auto buffer : buffers) {
+      av_free(buffer);
+    }
+  }
+}
+
+size_t ByteStoragePool::sizeClass(size_t n) {
+  if (n <= (size_t(1) << kMinClassBits)) {
+    return 0;
+  }
+  // 2^bits <= n - 1 < 2^(bits + 1)
+  size_t bits = 0;
+  while ((n - 1) >> (bits + 1)) {
+    ++bits;
+  }
+  // top three bits of n - 1, in [4, 7]
+  const size_t steps = (n - 1) >> (bits - 2);
+  return (bits - kMinClassBits) * 4 + steps - 3;
+}
+
+size_t ByteStoragePool::classSize(size_t sizeClass) {
+  return (4 + sizeClass % 4) << (sizeClass / 4 + kMinClassBits - 2);
+}
+
+uint8_t* ByteStoragePool::acquire(size_t n, size_t* capacity) {
+  const auto c = sizeClass(n);
+  *capacity = classSize(c);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (c < free_.size() && !free_[c].empty()) {
+      auto buffer = free_[c].back();
+      free_[c].pop_back();
+      return buffer;
+    }
+  }
+  auto buffer = static_cast<uint8_t*>(av_malloc(*capacity));
+  CHECK(buffer) << "av_malloc failed, size: " << *capacity;
+  return buffer;
+}
+
+void ByteStoragePool::release(uint8_t* buffer, size_t capacity) {
+  const auto c = sizeClass(capacity);
+  CHECK_EQ(classSize(c), capacity);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() <= c) {
+      free_.resize(c + 1);
+    }
+    if (free_[c].size() < kMaxFreePerClass) {
+      free_[c].push_back(buffer);
+      return;
+    }
+  }
+  av_free(buffer);
+}
+} // namespace ffmpeg
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "defs.h"
+
+namespace ffmpeg {
+
+/**
+ * Thread safe cache of av_malloc'ed buffers, grouped into size classes.
+ * Buffers of one class are interchangeable, so once decoding reaches the
+ * steady state every frame reuses the buffer released by a previous one,
+ * instead of allocating its own. Classes have four steps per power of two,
+ * a buffer is at most 25% larger than requested.
+ */
+class ByteStoragePool {
+ public:
+  ByteStoragePool() = default;
+  ~ByteStoragePool();
+  ByteStoragePool(const ByteStoragePool&) = delete;
+  ByteStoragePool& operator=(const ByteStoragePool&) = delete;
+
+  // returns a buffer of at least n bytes, its actual size goes to capacity
+  uint8_t* acquire(size_t n, size_t* capacity);
+  // gives the buffer back, capacity must be the one returned by acquire
+  void release(uint8_t* buffer, size_t capacity);
+
+  // size class of the smallest buffer holding n bytes, and its size
+  static size_t sizeClass(size_t n);
+  static size_t classSize(size_t sizeClass);
+
+ private:
+  std::mutex mutex_;
+  // released buffers, indexed by size class
+  std::vector<std::vector<uint8_t*>> free_;
+};
+} // namespace ffmpeg
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "byte_storage_pool.h"
+#include "sync_decoder.h"
+
+using namespace ffmpeg;
+
+TEST(ByteStoragePool, TestSizeClasses) {
+  for (size_t n = 1; n < (size_t(1) << 26); n = n * 3 / 2 + 1) {
+    const auto c = ByteStoragePool::sizeClass(n);
+    const auto size = ByteStoragePool::classSize(c);
+    EXPECT_GE(size, n);
+    if (c > 0) {
+      EXPECT_LT(ByteStoragePool::classSize(c - 1), n);
+      EXPECT_LE(size, n + n / 4 + 1);
+    }
+    EXPECT_EQ(ByteStoragePool::sizeClass(size), c);
+  }
+}
+
+TEST(ByteStoragePool, TestReuse) {
+  ByteStoragePool pool;
+  size_t capacity1, capacity2;
+  auto buffer = pool.acquire(1920 * 1080 * 3, &capacity1);
+  pool.release(buffer, capacity1);
+  // any size of the same class gets the released buffer
+  EXPECT_EQ(pool.acquire(1920 * 1080 * 3 - 1000, &capacity2), buffer);
+  EXPECT_EQ(capacity1, capacity2);
+  pool.release(buffer, capacity2);
+}
+
+TEST(ByteStoragePool, TestPayloadReturnsBuffer) {
+  auto pool = std::make_shared<ByteStoragePool>();
+  const uint8_t* buffer;
+  {
+    SyncDecoder::AVByteStorage storage(0, pool);
+    storage.ensure(1000000);
+    buffer = storage.writableTail();
+  }
+  SyncDecoder::AVByteStorage storage(0, pool);
+  storage.ensure(1000000);
+  EXPECT_EQ(storage.writableTail(), buffer);
+
+  // growing moves the data to a buffer of a larger class
+  memset(storage.writableTail(), 1, 1000000);
+  storage.append(1000000);
+  storage.trim(10);
+  storage.ensure(1000000);
+  EXPECT_EQ(storage.length(), 1000000 - 10);
+  EXPECT_GE(storage.tail(), 1000000);
+  EXPECT_EQ(storage.data()[storage.length() - 1], 1);
+}
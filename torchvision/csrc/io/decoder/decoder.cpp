@@ -16,6 +16,7 @@ namespace {
 constexpr size_t kIoBufferSize = 96 * 1024;
 constexpr size_t kIoPaddingSize = AV_INPUT_BUFFER_PADDING_SIZE;
 constexpr size_t kLogBufferSize = 1024;
+const AVRational timeBaseQ = AVRational{1, AV_TIME_BASE};
 
 int ffmpeg_lock(void** mutex, enum AVLockOp op) {
   std::mutex** handle = (std::mutex**)mutex;
@@ -380,20 +381,122 @@ bool Decoder::init(
     return false;
   }
 
+  if (params_.packetIndex && !preparePacketIndex()) {
+    cleanUp();
+    return false;
+  }
+
   onInit();
 
   if (params.startOffset != 0) {
-    auto offset = params.startOffset <= params.seekAccuracy
-        ? 0
-        : params.startOffset - params.seekAccuracy;
-
-    av_seek_frame(inputCtx_, -1, offset, AVSEEK_FLAG_BACKWARD);
+    seekInput(params.startOffset);
   }
 
   VLOG(1) << "Decoder initialized, log level: " << params_.logLevel;
   return true;
 }
 
+bool Decoder::preparePacketIndex() {
+  auto index = params_.packetIndex;
+  if (index->empty()) {
+    if (!inputCtx_->pb || !(inputCtx_->pb->seekable & AVIO_SEEKABLE_NORMAL)) {
+      VLOG(1) << "uuid=" << params_.loggingUuid
+              << " input is not seekable, no packet index";
+      return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    index->build(inputCtx_);
+    // back to the first packet
+    const auto start =
+        inputCtx_->start_time != AV_NOPTS_VALUE ? inputCtx_->start_time : 0;
+    int result;
+    if ((result = avformat_seek_file(
+             inputCtx_, -1, INT64_MIN, start, start, 0)) < 0) {
+      // the decoder would be left at the end of the input, without frames
+      LOG(ERROR) << "uuid=" << params_.loggingUuid
+                 << " cannot rewind after indexing, error="
+                 << Util::generateErrorDesc(result);
+      return false;
+    }
+    VLOG(1) << "uuid=" << params_.loggingUuid << " packet index built in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - now)
+                   .count()
+            << " ms";
+  } else if (!index->matches(inputCtx_)) {
+    // rebuilding it would read the whole input on every use of a stale index
+    LOG(ERROR) << "uuid=" << params_.loggingUuid
+               << " packet index doesn't match the input, ignoring it";
+    params_.packetIndex = nullptr;
+  }
+  return true;
+}
+
+int Decoder::seekInput(long offset) {
+  auto index = params_.packetIndex;
+  if (index && !index->empty() && !streams_.empty()) {
+    // the earliest of the key frames preceding the offset in the streams
+    int seekStream = -1;
+    int64_t seekPts = 0, seekUs = 0;
+    for (const auto& stream : streams_) {
+      const int i = stream.second->getIndex();
+      int64_t pts;
+      if (!index->keyFrameBefore(i, offset, &pts)) {
+        seekStream = -1;
+        break;
+      }
+      const auto us =
+          av_rescale_q(pts, inputCtx_->streams[i]->time_base, timeBaseQ);
+      if (seekStream < 0 || us < seekUs) {
+        seekStream = i;
+        seekPts = pts;
+        seekUs = us;
+      }
+    }
+    if (seekStream >= 0) {
+      VLOG(1) << "uuid=" << params_.loggingUuid << " seeking to key frame at "
+              << seekUs << " us, " << index->decodeCost(seekStream, offset)
+              << " packets to decode";
+      return av_seek_frame(
+          inputCtx_, seekStream, seekPts, AVSEEK_FLAG_BACKWARD);
+    }
+  }
+
+  const auto target =
+      offset <= params_.seekAccuracy ? 0 : offset - params_.seekAccuracy;
+  return av_seek_frame(inputCtx_, -1, target, AVSEEK_FLAG_BACKWARD);
+}
+
+bool Decoder::seek(long startOffset, long endOffset) {
+  if (!inputCtx_ || streams_.empty()) {
+    LOG(ERROR) << "uuid=" << params_.loggingUuid
+               << " cannot seek, decoder is not initialized";
+    return false;
+  }
+
+  int result;
+  if ((result = seekInput(startOffset)) < 0) {
+    LOG(ERROR) << "uuid=" << params_.loggingUuid
+               << " seek failed, error=" << Util::generateErrorDesc(result);
+    return false;
+  }
+
+  // frames of the previous position, either in the codecs or in the queue of
+  // the derived class, must not come out
+  inRange_.reset();
+  for (auto& stream : streams_) {
+    stream.second->flushBuffers();
+    inRange_.set(stream.second->getIndex(), true);
+  }
+  params_.startOffset = startOffset;
+  params_.endOffset = endOffset;
+  interrupted_ = false;
+  onInit();
+
+  VLOG(1) << "uuid=" << params_.loggingUuid << " seek to " << startOffset;
+  return true;
+}
+
 bool Decoder::openStreams(std::vector<DecoderMetadata>* metadata) {
   for (int i = 0; i < static_cast<int>(inputCtx_->nb_streams); i++) {
     // - find the corespondent format at params_.formats set
@@ -430,7 +533,8 @@ bool Decoder::openStreams(std::vector<DecoderMetadata>* metadata) {
           it->format,
           params_.loggingUuid);
       CHECK(stream);
-      if (stream->openCodec(metadata) < 0) {
+      if (stream->openCodec(
+              metadata, params_.numThreads, params_.threadType) < 0) {
         LOG(ERROR) << "uuid=" << params_.loggingUuid
                    << " open codec failed, stream_idx=" << i;
         return false;
@@ -614,7 +718,7 @@ int Decoder::processPacket(
   // decode package
   int result;
   DecoderOutputMessage msg;
-  msg.payload = params_.headerOnly ? nullptr : createByteStorage(0);
+  msg.payload = createPayload(*stream);
   *hasMsg = false;
   if ((result = stream->decodePacket(
            packet, &msg, params_.headerOnly, gotFrame)) >= 0 &&
@@ -625,7 +729,7 @@ int Decoder::processPacket(
     inRange_.set(stream->getIndex(), endInRange);
     if (endInRange && msg.header.pts >= params_.startOffset) {
       *hasMsg = true;
-      push(std::move(msg));
+      pushMessage(*stream, std::move(msg));
     }
   }
   return result;
@@ -635,14 +739,14 @@ void Decoder::flushStreams() {
   VLOG(1) << "Flushing streams...";
   for (auto& stream : streams_) {
     DecoderOutputMessage msg;
-    while (msg.payload = (params_.headerOnly ? nullptr : createByteStorage(0)),
+    while (msg.payload = createPayload(*stream.second),
            stream.second->flush(&msg, params_.headerOnly) > 0) {
       // check end offset
       bool endInRange =
           params_.endOffset <= 0 || msg.header.pts <= params_.endOffset;
       inRange_.set(stream.second->getIndex(), endInRange);
       if (endInRange && msg.header.pts >= params_.startOffset) {
-        push(std::move(msg));
+        pushMessage(*stream.second, std::move(msg));
       } else {
         msg.payload.reset();
       }
@@ -650,6 +754,25 @@ void Decoder::flushStreams() {
   }
 }
 
+std::unique_ptr<ByteStorage> Decoder::createPayload(const Stream& stream) {
+  if (params_.headerOnly) {
+    return nullptr;
+  }
+  if (params_.videoSink && stream.getMediaFormat().type == TYPE_VIDEO) {
+    return params_.videoSink->createFrameStorage();
+  }
+  return createByteStorage(0);
+}
+
+void Decoder::pushMessage(const Stream& stream, DecoderOutputMessage&& msg) {
+  if (msg.payload && params_.videoSink &&
+      stream.getMediaFormat().type == TYPE_VIDEO) {
+    // the frame stays in the sink, the message keeps the header only
+    params_.videoSink->commitFrame(std::move(msg.payload));
+  }
+  push(std::move(msg));
+}
+
 int Decoder::decode_all(const DecoderOutCallback& callback) {
   int result;
   do {
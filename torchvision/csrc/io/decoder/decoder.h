@@ -2,6 +2,7 @@
 
 #include <bitset>
 #include <unordered_map>
+#include "packet_index.h"
 #include "seekable_buffer.h"
 #include "stream.h"
 
@@ -31,6 +32,11 @@ class Decoder : public MediaDecoder {
   void shutdown() override;
   void interrupt() override;
 
+  // Seeks the open input to startOffset (us) without re-opening it or its
+  // codecs; the next decoded frames are the ones from startOffset to endOffset
+  // of the streams opened by init. Returns false if the input can't be sought.
+  virtual bool seek(long startOffset, long endOffset);
+
  protected:
   // function does actual work, derived class calls it in working thread
   // periodically. On success method returns 0, ENOADATA on EOF, ETIMEDOUT if
@@ -66,6 +72,12 @@ class Decoder : public MediaDecoder {
   virtual int shutdownCallback();
 
   bool openStreams(std::vector<DecoderMetadata>* metadata);
+  // builds params_.packetIndex if it's empty, drops it if it doesn't match the
+  // input. Returns false if the input can't be read from its start afterwards
+  bool preparePacketIndex();
+  // seeks the input before the offset (us), see DecoderParameters::packetIndex.
+  // Returns the av_seek_frame result
+  int seekInput(long offset);
   Stream* findByIndex(int streamIndex) const;
   Stream* findByType(const MediaFormat& format) const;
   int processPacket(
@@ -74,6 +86,10 @@ class Decoder : public MediaDecoder {
       bool* gotFrame,
       bool* hasMsg);
   void flushStreams();
+  // payload of the next message of the stream, null for header only decoding
+  std::unique_ptr<ByteStorage> createPayload(const Stream& stream);
+  // commits the frame of the video sink, if any, and pushes the message
+  void pushMessage(const Stream& stream, DecoderOutputMessage&& msg);
   void cleanUp();
 
  protected:
@@ -162,6 +162,9 @@ struct MediaFormat {
   FormatUnion format;
 };
 
+class FrameSink;
+class PacketIndex;
+
 struct DecoderParameters {
   // local file, remote file, http url, rtmp stream uri, etc. anything that
   // ffmpeg can recognize
@@ -196,6 +199,20 @@ struct DecoderParameters {
   double seekAccuracy{1000000.0};
   // what media types should be processed, default none
   std::set<MediaFormat> formats;
+  // number of codec decoding threads, 0 lets ffmpeg pick one per core
+  int numThreads{1};
+  // codec threading mode, bit mask of FF_THREAD_FRAME and FF_THREAD_SLICE,
+  // ffmpeg falls back to what the codec supports
+  int threadType{FF_THREAD_FRAME | FF_THREAD_SLICE};
+  // if set, video frames get written into the sink instead of the message
+  // payloads, the messages carry the headers only. Not owned, must outlive
+  // the decoding
+  FrameSink* videoSink{nullptr};
+  // if set, the decoder seeks to the key frames of the index rather than by
+  // seekAccuracy, an empty index gets built first if the input is seekable.
+  // An index of another input is ignored. Not owned, can be reused by the
+  // decoders of the same input
+  PacketIndex* packetIndex{nullptr};
 
   // can be used for asynchronous decoders
   size_t cacheSize{8192}; // mow many bytes to cache before stop reading bytes
@@ -249,6 +266,23 @@ struct DecoderOutputMessage {
   std::unique_ptr<ByteStorage> payload;
 };
 
+/**
+ * Destination of the decoded video frames, which bypasses the message
+ * payloads, e.g. to write frames straight into the caller's output buffer.
+ * The decoder samples every frame into a storage of the sink and commits the
+ * ones which pass the range checks, the others get dropped. Frames are
+ * committed in the order of their messages, the decoder must not drop
+ * messages after that.
+ */
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+  // storage for the next frame, only one exists at a time
+  virtual std::unique_ptr<ByteStorage> createFrameStorage() = 0;
+  // keeps the frame written into the storage
+  virtual void commitFrame(std::unique_ptr<ByteStorage> storage) = 0;
+};
+
 /*
  * External provider of the ecnoded bytes, specific implementation is left for
  * different use cases, like file, memory, external network end-points, etc.
@@ -0,0 +1,264 @@
+#include "packet_index.h"
+#include <c10/util/Logging.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace ffmpeg {
+
+namespace {
+const AVRational timeBaseQ = AVRational{1, AV_TIME_BASE};
+const uint32_t kMagic = 0x49505654; // "TVPI"
+const uint32_t kVersion = 3;
+
+template <typename T>
+void write(std::vector<uint8_t>& out, const T& value) {
+  const auto pos = out.size();
+  out.resize(pos + sizeof(value));
+  memcpy(out.data() + pos, &value, sizeof(value));
+}
+
+template <typename T>
+bool read(const uint8_t* data, size_t size, size_t& pos, T& value) {
+  if (size < pos + sizeof(value)) {
+    return false;
+  }
+  memcpy(&value, data + pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+// -1 if unknown
+int64_t fileSize(AVFormatContext* inputCtx) {
+  const int64_t size = inputCtx->pb ? avio_size(inputCtx->pb) : -1;
+  return size >= 0 ? size : -1;
+}
+} // namespace
+
+bool PacketIndex::build(AVFormatContext* inputCtx) {
+  clear();
+  AVPacket packet;
+  av_init_packet(&packet);
+  packet.data = nullptr;
+  packet.size = 0;
+
+  int result;
+  while ((result = av_read_frame(inputCtx, &packet)) >= 0 ||
+         result == AVERROR(EAGAIN)) {
+    if (result == AVERROR(EAGAIN)) {
+      std::this_thread::yield();
+      continue;
+    }
+    add(packet.stream_index,
+        inputCtx->streams[packet.stream_index]->time_base,
+        packet);
+    av_packet_unref(&packet);
+  }
+
+  if (result != AVERROR_EOF) {
+    LOG(ERROR) << "Packet indexing failed, error: " << result;
+    clear();
+    return false;
+  }
+  identify(inputCtx);
+  return true;
+}
+
+void PacketIndex::identify(AVFormatContext* inputCtx) {
+  fileSize_ = fileSize(inputCtx);
+  numStreams_ = inputCtx->nb_streams;
+  for (auto& it : streams_) {
+    if (it.first >= 0 && it.first < (int)inputCtx->nb_streams) {
+      const auto stream = inputCtx->streams[it.first];
+      it.second.codecId = stream->codecpar->codec_id;
+      it.second.duration = stream->duration;
+    }
+  }
+}
+
+void PacketIndex::add(int stream, AVRational timeBase, const AVPacket& packet) {
+  auto& index = streams_[stream];
+  index.timeBase = timeBase;
+  ++index.numPackets;
+
+  Entry entry;
+  entry.pts = packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts;
+  if (entry.pts == AV_NOPTS_VALUE) {
+    return; // can't be sought to
+  }
+  entry.pos = packet.pos;
+  entry.keyFrame = (packet.flags & AV_PKT_FLAG_KEY) != 0;
+
+  if (entry.keyFrame) {
+    // key frames come in pts order, but for broken streams
+    const auto& entries = index.entries;
+    auto it = std::upper_bound(
+        index.keyFrames.begin(),
+        index.keyFrames.end(),
+        entry.pts,
+        [&entries](int64_t pts, size_t i) { return pts < entries[i].pts; });
+    index.keyFrames.insert(it, index.entries.size());
+  }
+  index.entries.push_back(entry);
+}
+
+bool PacketIndex::matches(AVFormatContext* inputCtx) const {
+  if (numStreams_ != inputCtx->nb_streams ||
+      fileSize_ != fileSize(inputCtx)) {
+    return false;
+  }
+  for (const auto& it : streams_) {
+    if (it.first < 0 || it.first >= (int)inputCtx->nb_streams) {
+      return false;
+    }
+    const auto& index = it.second;
+    const auto stream = inputCtx->streams[it.first];
+    // nb_frames is the number of packets, when the container stores it
+    if (av_cmp_q(index.timeBase, stream->time_base) ||
+        index.codecId != stream->codecpar->codec_id ||
+        index.duration != stream->duration ||
+        (stream->nb_frames > 0 &&
+         (uint64_t)stream->nb_frames != index.numPackets)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const PacketIndex::StreamIndex* PacketIndex::findKeyFrame(
+    int stream,
+    int64_t ptsUs,
+    size_t* pos) const {
+  auto it = streams_.find(stream);
+  if (it == streams_.end() || it->second.keyFrames.empty()) {
+    return nullptr;
+  }
+  const auto& index = it->second;
+  // rounds down, not to miss a key frame right at ptsUs
+  const auto pts =
+      av_rescale_q_rnd(ptsUs, timeBaseQ, index.timeBase, AV_ROUND_DOWN);
+  auto key = std::upper_bound(
+      index.keyFrames.begin(),
+      index.keyFrames.end(),
+      pts,
+      [&index](int64_t value, size_t i) {
+        return value < index.entries[i].pts;
+      });
+  *pos = key == index.keyFrames.begin() ? *key : *(key - 1);
+  return &index;
+}
+
+bool PacketIndex::keyFrameBefore(
+    int stream,
+    int64_t ptsUs,
+    int64_t* keyFramePts) const {
+  size_t pos;
+  const auto index = findKeyFrame(stream, ptsUs, &pos);
+  if (!index) {
+    return false;
+  }
+  *keyFramePts = index->entries[pos].pts;
+  return true;
+}
+
+size_t PacketIndex::decodeCost(int stream, int64_t ptsUs) const {
+  size_t pos;
+  const auto index = findKeyFrame(stream, ptsUs, &pos);
+  if (!index) {
+    return 0;
+  }
+  const auto& entries = index->entries;
+  const auto pts =
+      av_rescale_q_rnd(ptsUs, timeBaseQ, index->timeBase, AV_ROUND_DOWN);
+  // the frame at ptsUs is the one with the smallest pts >= ptsUs, packets of
+  // the following groups of pictures come after a key frame past ptsUs
+  size_t frame = entries.size();
+  for (size_t i = pos; i < entries.size(); ++i) {
+    if (i > pos && entries[i].keyFrame && entries[i].pts > pts) {
+      break;
+    }
+    if (entries[i].pts >= pts &&
+        (frame == entries.size() || entries[i].pts < entries[frame].pts)) {
+      frame = i;
+    }
+  }
+  return frame == entries.size() ? entries.size() - pos : frame - pos + 1;
+}
+
+std::vector<uint8_t> PacketIndex::serialize() const {
+  std::vector<uint8_t> out;
+  write(out, kMagic);
+  write(out, kVersion);
+  write(out, fileSize_);
+  write(out, numStreams_);
+  write(out, (uint32_t)streams_.size());
+  for (const auto& it : streams_) {
+    const auto& index = it.second;
+    write(out, (int32_t)it.first);
+    write(out, (int32_t)index.timeBase.num);
+    write(out, (int32_t)index.timeBase.den);
+    write(out, (int32_t)index.codecId);
+    write(out, index.duration);
+    write(out, index.numPackets);
+    write(out, (uint64_t)index.entries.size());
+    for (const auto& entry : index.entries) {
+      write(out, entry.pts);
+      write(out, entry.pos);
+      write(out, (uint8_t)entry.keyFrame);
+    }
+  }
+  return out;
+}
+
+bool PacketIndex::deserialize(const uint8_t* data, size_t size) {
+  clear();
+  size_t pos = 0;
+  uint32_t magic, version, numStreams;
+  int64_t inputSize;
+  uint32_t numInputStreams;
+  if (!read(data, size, pos, magic) || magic != kMagic ||
+      !read(data, size, pos, version) || version != kVersion ||
+      !read(data, size, pos, inputSize) ||
+      !read(data, size, pos, numInputStreams) ||
+      !read(data, size, pos, numStreams)) {
+    LOG(ERROR) << "Not a packet index";
+    return false;
+  }
+  for (uint32_t s = 0; s < numStreams; ++s) {
+    int32_t stream, num, den, codecId;
+    int64_t duration;
+    uint64_t numPackets, numEntries;
+    if (!read(data, size, pos, stream) || !read(data, size, pos, num) ||
+        !read(data, size, pos, den) || !read(data, size, pos, codecId) ||
+        !read(data, size, pos, duration) ||
+        !read(data, size, pos, numPackets) ||
+        !read(data, size, pos, numEntries)) {
+      clear();
+      return false;
+    }
+    for (uint64_t i = 0; i < numEntries; ++i) {
+      AVPacket packet;
+      av_init_packet(&packet);
+      uint8_t keyFrame;
+      if (!read(data, size, pos, packet.pts) ||
+          !read(data, size, pos, packet.pos) ||
+          !read(data, size, pos, keyFrame)) {
+        LOG(ERROR) << "Truncated packet index";
+        clear();
+        return false;
+      }
+      packet.flags = keyFrame ? AV_PKT_FLAG_KEY : 0;
+      add(stream, AVRational{num, den}, packet);
+    }
+    // the stream is kept even if none of its packets had timestamps
+    auto& index = streams_[stream];
+    index.timeBase = AVRational{num, den};
+    index.codecId = codecId;
+    index.duration = duration;
+    index.numPackets = numPackets;
+  }
+  fileSize_ = inputSize;
+  numStreams_ = numInputStreams;
+  return true;
+}
+} // namespace ffmpeg
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include "defs.h"
+
+namespace ffmpeg {
+
+/**
+ * Index of the packets of a media file: pts, key frame flag and byte offset of
+ * every packet of every stream, in decoding order. With it the decoder seeks
+ * straight to the key frame preceding the start offset, instead of seeking
+ * DecoderParameters::seekAccuracy earlier, and it tells how many packets have
+ * to be decoded to reach a frame. Building an index reads the whole file
+ * once, it can be serialized and reused by the later decoders of the file.
+ */
+class PacketIndex {
+ public:
+  struct Entry {
+    // in the stream time base
+    int64_t pts{0};
+    // byte offset in the file, -1 if unknown
+    int64_t pos{-1};
+    bool keyFrame{false};
+  };
+
+  bool empty() const {
+    return streams_.empty();
+  }
+  void clear() {
+    streams_.clear();
+    fileSize_ = -1;
+    numStreams_ = 0;
+  }
+
+  // reads all packets of the input from its current position, the caller
+  // seeks back afterwards. Returns false on read error
+  bool build(AVFormatContext* inputCtx);
+  // appends the packet of the stream, packets must come in decoding order
+  void add(int stream, AVRational timeBase, const AVPacket& packet);
+  // records the fingerprint of the input compared by matches: its size, its
+  // number of streams, and the codec and duration of the indexed streams.
+  // Called by build, after the packets are added
+  void identify(AVFormatContext* inputCtx);
+  // checks that the index is the one of the input, from the fingerprint and
+  // the number of packets of the streams, where the container tells it
+  bool matches(AVFormatContext* inputCtx) const;
+
+  // finds the last key frame of the stream with pts <= ptsUs, or the first
+  // one if ptsUs precedes them all. Returns false if the stream is not indexed
+  bool keyFrameBefore(int stream, int64_t ptsUs, int64_t* keyFramePts) const;
+  // number of packets to decode from that key frame to the frame at ptsUs
+  size_t decodeCost(int stream, int64_t ptsUs) const;
+
+  std::vector<uint8_t> serialize() const;
+  bool deserialize(const uint8_t* data, size_t size);
+
+ private:
+  struct StreamIndex {
+    AVRational timeBase{0, 1};
+    int codecId{AV_CODEC_ID_NONE};
+    int64_t duration{AV_NOPTS_VALUE};
+    // packets of the stream, including those without timestamps which are
+    // not in entries
+    uint64_t numPackets{0};
+    std::vector<Entry> entries;
+    // positions of the key frames in entries, sorted by pts
+    std::vector<size_t> keyFrames;
+  };
+
+  // position in entries of the key frame found by keyFrameBefore
+  const StreamIndex* findKeyFrame(int stream, int64_t ptsUs, size_t* pos)
+      const;
+
+  std::map<int, StreamIndex> streams_;
+  // -1 if unknown
+  int64_t fileSize_{-1};
+  uint32_t numStreams_{0};
+};
+} // namespace ffmpeg
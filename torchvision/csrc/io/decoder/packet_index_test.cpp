@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "packet_index.h"
+
+using namespace ffmpeg;
+
+namespace {
+const AVRational kTimeBase = AVRational{1, 90000};
+// 30 fps
+const int64_t kFrameTicks = 3000;
+
+// groups of 12 pictures, with B-frames: I P B B P B B ... in decoding order
+PacketIndex makeIndex(int numGroups) {
+  PacketIndex index;
+  const int order[] = {0, 3, 1, 2, 6, 4, 5, 9, 7, 8, 11, 10};
+  for (int g = 0; g < numGroups; ++g) {
+    for (int k : order) {
+      AVPacket packet;
+      av_init_packet(&packet);
+      packet.pts = (g * 12 + k) * kFrameTicks;
+      packet.pos = (g * 12 + k) * 100;
+      packet.flags = k == 0 ? AV_PKT_FLAG_KEY : 0;
+      index.add(0, kTimeBase, packet);
+    }
+  }
+  return index;
+}
+
+int64_t frameUs(int frame) {
+  return frame * AV_TIME_BASE / 30;
+}
+} // namespace
+
+TEST(PacketIndex, TestKeyFrameBefore) {
+  const auto index = makeIndex(5);
+  for (int frame = 0; frame < 60; ++frame) {
+    int64_t pts;
+    ASSERT_TRUE(index.keyFrameBefore(0, frameUs(frame), &pts));
+    EXPECT_EQ(pts, (frame / 12) * 12 * kFrameTicks);
+  }
+  int64_t pts;
+  EXPECT_FALSE(index.keyFrameBefore(1, 0, &pts));
+}
+
+TEST(PacketIndex, TestDecodeCost) {
+  const auto index = makeIndex(5);
+  EXPECT_EQ(index.decodeCost(0, frameUs(12)), 1);
+  // the B-frame comes after the P-frame it refers to
+  EXPECT_EQ(index.decodeCost(0, frameUs(13)), 3);
+  EXPECT_EQ(index.decodeCost(0, frameUs(15)), 2);
+  EXPECT_EQ(index.decodeCost(0, frameUs(23)), 11);
+}
+
+TEST(PacketIndex, TestSerialization) {
+  const auto index = makeIndex(3);
+  const auto bytes = index.serialize();
+
+  PacketIndex copy;
+  ASSERT_TRUE(copy.deserialize(bytes.data(), bytes.size()));
+  EXPECT_EQ(copy.serialize(), bytes);
+
+  EXPECT_FALSE(copy.deserialize(bytes.data(), bytes.size() - 1));
+  EXPECT_TRUE(copy.empty());
+}
+
+TEST(PacketIndex, TestMatches) {
+  AVFormatContext* ctx = avformat_alloc_context();
+  AVStream* stream = avformat_new_stream(ctx, nullptr);
+  stream->time_base = kTimeBase;
+  stream->codecpar->codec_id = AV_CODEC_ID_H264;
+  stream->duration = 60 * kFrameTicks;
+  stream->nb_frames = 60;
+
+  auto index = makeIndex(5);
+  // not identified yet
+  EXPECT_FALSE(index.matches(ctx));
+  index.identify(ctx);
+  EXPECT_TRUE(index.matches(ctx));
+
+  PacketIndex copy;
+  const auto bytes = index.serialize();
+  ASSERT_TRUE(copy.deserialize(bytes.data(), bytes.size()));
+  EXPECT_TRUE(copy.matches(ctx));
+
+  // another file with the same time base
+  stream->duration = 61 * kFrameTicks;
+  EXPECT_FALSE(index.matches(ctx));
+  stream->duration = 60 * kFrameTicks;
+  stream->codecpar->codec_id = AV_CODEC_ID_HEVC;
+  EXPECT_FALSE(index.matches(ctx));
+  stream->codecpar->codec_id = AV_CODEC_ID_H264;
+  stream->nb_frames = 61;
+  EXPECT_FALSE(index.matches(ctx));
+  stream->nb_frames = 0;
+  EXPECT_TRUE(index.matches(ctx));
+
+  // packets without timestamps are not in the index, but they are counted
+  AVPacket packet;
+  av_init_packet(&packet);
+  index.add(0, kTimeBase, packet);
+  stream->nb_frames = 61;
+  EXPECT_TRUE(index.matches(ctx));
+  const auto counted = index.serialize();
+  ASSERT_TRUE(copy.deserialize(counted.data(), counted.size()));
+  EXPECT_TRUE(copy.matches(ctx));
+
+  avformat_new_stream(ctx, nullptr);
+  EXPECT_FALSE(index.matches(ctx));
+
+  avformat_free_context(ctx);
+}
@@ -28,7 +28,10 @@ AVCodec* Stream::findCodec(AVCodecParameters* params) {
   return avcodec_find_decoder(params->codec_id);
 }
 
-int Stream::openCodec(std::vector<DecoderMetadata>* metadata) {
+int Stream::openCodec(
+    std::vector<DecoderMetadata>* metadata,
+    int numThreads,
+    int threadType) {
   AVStream* steam = inputCtx_->streams[format_.stream];
 
   AVCodec* codec = findCodec(steam->codecpar);
@@ -53,6 +56,10 @@ int Stream::openCodec(std::vector<DecoderMetadata>* metadata) {
     return ret;
   }
 
+  // codecs without threading support ignore both
+  codecCtx_->thread_count = numThreads;
+  codecCtx_->thread_type = threadType;
+
   // after avcodec_open2, value of codecCtx_->time_base is NOT meaningful
   if ((ret = avcodec_open2(codecCtx_, codec, nullptr)) < 0) {
     LOG(ERROR) << "LoggingUuid #" << loggingUuid_
@@ -167,6 +174,12 @@ int Stream::flush(DecoderOutputMessage* out, bool headerOnly) {
   return 1;
 }
 
+void Stream::flushBuffers() {
+  if (codecCtx_) {
+    avcodec_flush_buffers(codecCtx_);
+  }
+}
+
 int Stream::getMessage(DecoderOutputMessage* out, bool flush, bool headerOnly) {
   if (flush) {
     // only flush of audio frames makes sense
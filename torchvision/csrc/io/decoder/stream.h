@@ -20,7 +20,10 @@ class Stream {
   virtual ~Stream();
 
   // returns 0 - on success or negative error
-  int openCodec(std::vector<DecoderMetadata>* metadata);
+  int openCodec(
+      std::vector<DecoderMetadata>* metadata,
+      int numThreads,
+      int threadType);
   // returns 1 - if packet got consumed, 0 - if it's not, and < 0 on error
   int decodePacket(
       const AVPacket* packet,
@@ -33,6 +36,8 @@ class Stream {
   }
   // returns 1 - if message got a payload, 0 - if it's not, and < 0 on error
   int flush(DecoderOutputMessage* out, bool headerOnly);
+  // drops the frames buffered by the codec, before decoding from a new position
+  void flushBuffers();
   // return media format
   MediaFormat getMediaFormat() const {
     return format_;
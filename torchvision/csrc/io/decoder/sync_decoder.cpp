@@ -1,20 +1,43 @@
 #include "sync_decoder.h"
 #include <c10/util/Logging.h>
+#include <cstring>
 
 namespace ffmpeg {
 
-SyncDecoder::AVByteStorage::AVByteStorage(size_t n) {
+SyncDecoder::AVByteStorage::AVByteStorage(
+    size_t n,
+    std::shared_ptr<ByteStoragePool> pool)
+    : pool_(std::move(pool)) {
   ensure(n);
 }
 
 SyncDecoder::AVByteStorage::~AVByteStorage() {
-  av_free(buffer_);
+  if (pool_ && buffer_) {
+    pool_->release(buffer_, capacity_);
+  } else {
+    av_free(buffer_);
+  }
 }
 
 void SyncDecoder::AVByteStorage::ensure(size_t n) {
   if (tail() < n) {
-    capacity_ = offset_ + length_ + n;
-    buffer_ = static_cast<uint8_t*>(av_realloc(buffer_, capacity_));
+    if (!pool_) {
+      capacity_ = offset_ + length_ + n;
+      buffer_ = static_cast<uint8_t*>(av_realloc(buffer_, capacity_));
+      return;
+    }
+    // pooled buffers have fixed sizes, move the data into a larger one
+    size_t capacity;
+    uint8_t* buffer = pool_->acquire(length_ + n, &capacity);
+    if (length_ > 0) {
+      memcpy(buffer, buffer_ + offset_, length_);
+    }
+    if (buffer_) {
+      pool_->release(buffer_, capacity_);
+    }
+    buffer_ = buffer;
+    capacity_ = capacity;
+    offset_ = 0;
   }
 }
 
@@ -53,7 +76,7 @@ void SyncDecoder::AVByteStorage::clear() {
 }
 
 std::unique_ptr<ByteStorage> SyncDecoder::createByteStorage(size_t n) {
-  return std::make_unique<AVByteStorage>(n);
+  return std::make_unique<AVByteStorage>(n, pool_);
 }
 
 void SyncDecoder::onInit() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include "byte_storage_pool.h"
 #include "decoder.h"
 
 namespace ffmpeg {
@@ -13,9 +14,12 @@ namespace ffmpeg {
 class SyncDecoder : public Decoder {
  public:
   // Allocation of memory must be done with a proper alignment.
+  // With a pool, the buffer comes from it and goes back to it on destruction.
   class AVByteStorage : public ByteStorage {
    public:
-    explicit AVByteStorage(size_t n);
+    explicit AVByteStorage(
+        size_t n,
+        std::shared_ptr<ByteStoragePool> pool = nullptr);
     ~AVByteStorage() override;
     void ensure(size_t n) override;
     uint8_t* writableTail() override;
@@ -31,6 +35,7 @@ class SyncDecoder : public Decoder {
     size_t length_{0};
     size_t capacity_{0};
     uint8_t* buffer_{nullptr};
+    std::shared_ptr<ByteStoragePool> pool_;
   };
 
  public:
@@ -44,5 +49,7 @@ class SyncDecoder : public Decoder {
  private:
   std::list<DecoderOutputMessage> queue_;
   bool eof_{false};
+  // shared with the payloads, which may outlive the decoder
+  std::shared_ptr<ByteStoragePool> pool_{std::make_shared<ByteStoragePool>()};
 };
 } // namespace ffmpeg
@@ -410,3 +410,95 @@ TEST(SyncDecoder, TestMemoryBufferNoSeekableWithPartialRead) {
       },
       nullptr));
 }
+
+TEST(SyncDecoder, TestVideoSink) {
+  // keeps the committed frames one after another
+  struct Sink : FrameSink {
+    std::unique_ptr<ByteStorage> createFrameStorage() override {
+      return std::make_unique<SyncDecoder::AVByteStorage>(0);
+    }
+    void commitFrame(std::unique_ptr<ByteStorage> storage) override {
+      frames.push_back(std::move(storage));
+    }
+    std::vector<std::unique_ptr<ByteStorage>> frames;
+  } sink;
+
+  DecoderParameters params;
+  params.timeoutMs = 10000;
+  params.startOffset = 1000000;
+  params.endOffset = 3000000;
+  params.seekAccuracy = 100000;
+  params.formats = {MediaFormat(), MediaFormat(0)};
+  params.uri = "pytorch/vision/test/assets/videos/R6llTwEh07w.mp4";
+
+  std::vector<size_t> expected;
+  SyncDecoder decoder;
+  CHECK(decoder.init(params, nullptr, nullptr));
+  DecoderOutputMessage out;
+  while (0 == decoder.decode(&out, 10000)) {
+    if (out.header.format.type == TYPE_VIDEO) {
+      expected.push_back(out.payload->length());
+    }
+  }
+  decoder.shutdown();
+
+  params.videoSink = &sink;
+  size_t numVideoMessages = 0;
+  CHECK(decoder.init(params, nullptr, nullptr));
+  while (0 == decoder.decode(&out, 10000)) {
+    if (out.header.format.type == TYPE_VIDEO) {
+      // the frame went to the sink
+      EXPECT_EQ(out.payload, nullptr);
+      EXPECT_EQ(sink.frames.size(), ++numVideoMessages);
+    } else {
+      EXPECT_NE(out.payload, nullptr);
+    }
+  }
+  decoder.shutdown();
+
+  ASSERT_EQ(sink.frames.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(sink.frames[i]->length(), expected[i]);
+  }
+}
+
+TEST(SyncDecoder, TestSeek) {
+  DecoderParameters params;
+  params.timeoutMs = 10000;
+  params.seekAccuracy = 100000;
+  params.formats = {MediaFormat(0)};
+  params.uri = "pytorch/vision/test/assets/videos/R6llTwEh07w.mp4";
+
+  auto nextFrame = [](SyncDecoder& decoder, DecoderOutputMessage* out) {
+    CHECK_EQ(0, decoder.decode(out, 10000));
+  };
+
+  SyncDecoder seeking;
+  CHECK(seeking.init(params, nullptr, nullptr));
+  DecoderOutputMessage out;
+  nextFrame(seeking, &out);
+
+  for (long offset : {2000000, 1000000, 2000000, 0}) {
+    params.startOffset = offset;
+    SyncDecoder decoder;
+    CHECK(decoder.init(params, nullptr, nullptr));
+    DecoderOutputMessage expected;
+    nextFrame(decoder, &expected);
+    decoder.shutdown();
+
+    // the codecs and the queue keep nothing of the previous position
+    ASSERT_TRUE(seeking.seek(offset, -1));
+    nextFrame(seeking, &out);
+    EXPECT_EQ(out.header.pts, expected.header.pts);
+    ASSERT_EQ(out.payload->length(), expected.payload->length());
+    EXPECT_EQ(
+        0,
+        memcmp(
+            out.payload->data(),
+            expected.payload->data(),
+            expected.payload->length()));
+    // some more frames are decoded before seeking again
+    nextFrame(seeking, &out);
+  }
+  seeking.shutdown();
+}
@@ -398,5 +398,16 @@ void setFormatDimensions(
   destW = std::max(destW, size_t(1UL));
   destH = std::max(destH, size_t(1UL));
 }
+
+int parseThreadType(const std::string& threadType) {
+  if (threadType == "auto") {
+    return FF_THREAD_FRAME | FF_THREAD_SLICE;
+  } else if (threadType == "frame") {
+    return FF_THREAD_FRAME;
+  } else if (threadType == "slice") {
+    return FF_THREAD_SLICE;
+  }
+  return 0;
+}
 } // namespace Util
 } // namespace ffmpeg
@@ -24,5 +24,7 @@ void setFormatDimensions(
     size_t maxDimension,
     size_t cropImage);
 bool validateVideoFormat(const VideoFormat& format);
+// maps "auto", "frame" or "slice" to the FF_THREAD_* bit mask, 0 if unknown
+int parseThreadType(const std::string& threadType);
 } // namespace Util
 } // namespace ffmpeg
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <torch/types.h>
+
+namespace vision {
+namespace image {
+namespace detail {
+
+// Memory layouts of a [C, H, W] tensor that the decoders write to directly
+enum class DecodeOutputLayout { Invalid, ChannelsLast, Planar };
+
+// Returns the layout in which a decoded image of the given shape has to be
+// written into out, or Invalid when out can not receive it
+inline DecodeOutputLayout get_decode_output_layout(
+    const torch::Tensor& out,
+    int64_t channels,
+    int64_t height,
+    int64_t width) {
+  if (out.scalar_type() != torch::kU8 || !out.device().is_cpu() ||
+      out.dim() != 3 || out.size(0) != channels || out.size(1) != height ||
+      out.size(2) != width) {
+    return DecodeOutputLayout::Invalid;
+  }
+  // Checked first: a single channel image is both planar and channels last
+  if (out.permute({1, 2, 0}).is_contiguous()) {
+    return DecodeOutputLayout::ChannelsLast;
+  }
+  if (out.is_contiguous()) {
+    return DecodeOutputLayout::Planar;
+  }
+  return DecodeOutputLayout::Invalid;
+}
+
+inline std::string decode_output_error(
+    const torch::Tensor& out,
+    int64_t channels,
+    int64_t height,
+    int64_t width) {
+  return c10::str(
+      "Expected out to be a uint8 CPU tensor of shape [",
+      channels,
+      ", ",
+      height,
+      ", ",
+      width,
+      "], either contiguous or channels last, got a ",
+      out.scalar_type(),
+      " tensor of shape ",
+      out.sizes(),
+      " and strides ",
+      out.strides());
+}
+
+} // namespace detail
+} // namespace image
+} // namespace vision
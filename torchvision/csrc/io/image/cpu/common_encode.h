@@ -0,0 +1,57 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <cstring>
+
+namespace vision {
+namespace image {
+namespace detail {
+
+// Output buffer of the encoders, backed by a uint8 tensor so that the encoded
+// image is returned without copying it out of a malloc'd buffer. It starts
+// from a size estimate and doubles when the encoder runs out of space.
+class EncodeOutputBuffer {
+ public:
+  explicit EncodeOutputBuffer(int64_t capacity)
+      : tensor_(torch::empty({std::max<int64_t>(capacity, 1024)}, torch::kU8)) {
+  }
+
+  uint8_t* data() {
+    return tensor_.data_ptr<uint8_t>();
+  }
+
+  int64_t capacity() const {
+    return tensor_.numel();
+  }
+
+  // Grows the buffer to at least min_capacity bytes, keeping its first size
+  // bytes. Returns false if the allocation failed: this is called from the
+  // libjpeg and libpng callbacks, which must report errors their own way.
+  bool grow(int64_t size, int64_t min_capacity) noexcept {
+    try {
+      auto grown = torch::empty(
+          {std::max(2 * capacity(), min_capacity)}, torch::kU8);
+      std::memcpy(grown.data_ptr<uint8_t>(), data(), size);
+      tensor_ = std::move(grown);
+      return true;
+    } catch (...) {
+      return false;
+    }
+  }
+
+  // Returns the first size bytes of the buffer. When less than half of the
+  // buffer is used, they are copied out so that the estimate is not kept
+  // alive with the output.
+  torch::Tensor finish(int64_t size) {
+    auto output = tensor_.narrow(0, 0, size);
+    return 2 * size < capacity() ? output.clone() : output;
+  }
+
+ private:
+  torch::Tensor tensor_;
+};
+
+} // namespace detail
+} // namespace image
+} // namespace vision
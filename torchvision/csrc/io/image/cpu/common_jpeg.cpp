@@ -1,4 +1,12 @@
 #include "common_jpeg.h"
+#include "common_encode.h"
+
+#include <cstring>
+
+#if JPEG_FOUND
+// Error codes of libjpeg, it has to come after jpeglib.h
+#include <jerror.h>
+#endif
 
 namespace vision {
 namespace image {
@@ -19,6 +27,101 @@ void torch_jpeg_error_exit(j_common_ptr cinfo) {
   /* Return control to the setjmp point */
   longjmp(myerr->setjmp_buffer, 1);
 }
+
+namespace {
+
+struct torch_jpeg_mgr {
+  struct jpeg_source_mgr pub;
+  const JOCTET* data;
+  size_t len;
+};
+
+void torch_jpeg_init_source(j_decompress_ptr cinfo) {}
+
+boolean torch_jpeg_fill_input_buffer(j_decompress_ptr cinfo) {
+  // No more data.  Probably an incomplete image;  Raise exception.
+  torch_jpeg_error_ptr myerr = (torch_jpeg_error_ptr)cinfo->err;
+  strcpy(myerr->jpegLastErrorMsg, "Image is incomplete or truncated");
+  longjmp(myerr->setjmp_buffer, 1);
+}
+
+void torch_jpeg_skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
+  torch_jpeg_mgr* src = (torch_jpeg_mgr*)cinfo->src;
+  if (src->pub.bytes_in_buffer < (size_t)num_bytes) {
+    // Skipping over all of remaining data;  output EOI.
+    src->pub.next_input_byte = EOI_BUFFER;
+    src->pub.bytes_in_buffer = 1;
+  } else {
+    // Skipping over only some of the remaining data.
+    src->pub.next_input_byte += num_bytes;
+    src->pub.bytes_in_buffer -= num_bytes;
+  }
+}
+
+void torch_jpeg_term_source(j_decompress_ptr cinfo) {}
+
+using torch_jpeg_mgr_dest_ptr = torch_jpeg_mgr_dest*;
+
+void torch_jpeg_init_destination(j_compress_ptr cinfo) {
+  auto dest = (torch_jpeg_mgr_dest_ptr)cinfo->dest;
+  dest->size = 0;
+  dest->pub.next_output_byte = dest->buffer->data();
+  dest->pub.free_in_buffer = dest->buffer->capacity();
+}
+
+boolean torch_jpeg_empty_output_buffer(j_compress_ptr cinfo) {
+  auto dest = (torch_jpeg_mgr_dest_ptr)cinfo->dest;
+  // libjpeg only calls this once the whole buffer is full, regardless of
+  // free_in_buffer
+  dest->size = dest->buffer->capacity();
+  if (!dest->buffer->grow(dest->size, dest->size + 1)) {
+    ERREXIT1(cinfo, JERR_OUT_OF_MEMORY, 0);
+  }
+  dest->pub.next_output_byte = dest->buffer->data() + dest->size;
+  dest->pub.free_in_buffer = dest->buffer->capacity() - dest->size;
+  return TRUE;
+}
+
+void torch_jpeg_term_destination(j_compress_ptr cinfo) {
+  auto dest = (torch_jpeg_mgr_dest_ptr)cinfo->dest;
+  dest->size = dest->buffer->capacity() - dest->pub.free_in_buffer;
+}
+
+} // namespace
+
+void torch_jpeg_set_source_mgr(
+    j_decompress_ptr cinfo,
+    const unsigned char* data,
+    size_t len) {
+  torch_jpeg_mgr* src;
+  if (cinfo->src == 0) { // if this is first time;  allocate memory
+    cinfo->src = (struct jpeg_source_mgr*)(*cinfo->mem->alloc_small)(
+        (j_common_ptr)cinfo, JPOOL_PERMANENT, sizeof(torch_jpeg_mgr));
+  }
+  src = (torch_jpeg_mgr*)cinfo->src;
+  src->pub.init_source = torch_jpeg_init_source;
+  src->pub.fill_input_buffer = torch_jpeg_fill_input_buffer;
+  src->pub.skip_input_data = torch_jpeg_skip_input_data;
+  src->pub.resync_to_restart = jpeg_resync_to_restart; // default
+  src->pub.term_source = torch_jpeg_term_source;
+  // fill the buffers
+  src->data = (const JOCTET*)data;
+  src->len = len;
+  src->pub.bytes_in_buffer = len;
+  src->pub.next_input_byte = src->data;
+}
+
+void torch_jpeg_set_dest(
+    j_compress_ptr cinfo,
+    torch_jpeg_mgr_dest* dest,
+    EncodeOutputBuffer* buffer) {
+  dest->pub.init_destination = torch_jpeg_init_destination;
+  dest->pub.empty_output_buffer = torch_jpeg_empty_output_buffer;
+  dest->pub.term_destination = torch_jpeg_term_destination;
+  dest->buffer = buffer;
+  dest->size = 0;
+  cinfo->dest = &dest->pub;
+}
 #endif
 
 } // namespace detail
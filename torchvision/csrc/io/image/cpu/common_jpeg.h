@@ -1,6 +1,7 @@
 #pragma once
 
 #if JPEG_FOUND
+#include <stdint.h>
 #include <stdio.h>
 
 #include <jpeglib.h>
@@ -20,6 +21,28 @@ struct torch_jpeg_error_mgr {
 using torch_jpeg_error_ptr = struct torch_jpeg_error_mgr*;
 void torch_jpeg_error_exit(j_common_ptr cinfo);
 
+// Reads the compressed image from data, which must outlive the decompression
+void torch_jpeg_set_source_mgr(
+    j_decompress_ptr cinfo,
+    const unsigned char* data,
+    size_t len);
+
+class EncodeOutputBuffer;
+
+// Destination manager writing the compressed image into an
+// EncodeOutputBuffer. size is the number of bytes written once the
+// compression is finished.
+struct torch_jpeg_mgr_dest {
+  struct jpeg_destination_mgr pub;
+  EncodeOutputBuffer* buffer;
+  int64_t size;
+};
+
+void torch_jpeg_set_dest(
+    j_compress_ptr cinfo,
+    torch_jpeg_mgr_dest* dest,
+    EncodeOutputBuffer* buffer);
+
 } // namespace detail
 } // namespace image
 } // namespace vision
@@ -0,0 +1,42 @@
+#include "decode_batch.h"
+
+#include "decode_image.h"
+#include "decode_jpeg.h"
+#include "parallel_batch.h"
+
+namespace vision {
+namespace image {
+
+DecodeBatchResult decode_jpeg_batch(
+    const torch::List<torch::Tensor>& data,
+    ImageReadMode mode,
+    int64_t num_threads) {
+  return detail::parallel_map_tensors(
+      data, num_threads, [&](const torch::Tensor& input) {
+        return decode_jpeg(input, mode);
+      });
+}
+
+DecodeBatchResult decode_image_batch(
+    const torch::List<torch::Tensor>& data,
+    ImageReadMode mode,
+    int64_t num_threads) {
+  return detail::parallel_map_tensors(
+      data, num_threads, [&](const torch::Tensor& input) {
+        return decode_image(input, mode);
+      });
+}
+
+DecodeBatchResult decode_image_from_file_batch(
+    const torch::List<std::string>& paths,
+    ImageReadMode mode,
+    int64_t num_threads,
+    bool mmap) {
+  return detail::parallel_map_tensors(
+      paths, num_threads, [&](const std::string& path) {
+        return decode_image_from_file(path, mode, mmap);
+      });
+}
+
+} // namespace image
+} // namespace vision
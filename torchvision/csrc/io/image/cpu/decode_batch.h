@@ -0,0 +1,34 @@
+#pragma once
+
+#include <torch/types.h>
+#include "../image_read_mode.h"
+
+namespace vision {
+namespace image {
+
+// The batched decoders return the decoded images along with one error message
+// per input: a failed decode yields an empty tensor and a non empty message,
+// the other images of the batch are still decoded.
+using DecodeBatchResult =
+    std::tuple<torch::List<torch::Tensor>, torch::List<std::string>>;
+
+C10_EXPORT DecodeBatchResult decode_jpeg_batch(
+    const torch::List<torch::Tensor>& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t num_threads = 0);
+
+C10_EXPORT DecodeBatchResult decode_image_batch(
+    const torch::List<torch::Tensor>& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t num_threads = 0);
+
+// Same as decode_image_batch, for the images stored at the given paths, each
+// decoded with decode_image_from_file
+C10_EXPORT DecodeBatchResult decode_image_from_file_batch(
+    const torch::List<std::string>& paths,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t num_threads = 0,
+    bool mmap = false);
+
+} // namespace image
+} // namespace vision
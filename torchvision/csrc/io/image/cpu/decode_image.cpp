@@ -2,11 +2,16 @@
 
 #include "decode_jpeg.h"
 #include "decode_png.h"
+#include "read_write_file.h"
 
 namespace vision {
 namespace image {
 
-torch::Tensor decode_image(const torch::Tensor& data, ImageReadMode mode) {
+namespace {
+
+enum class ImageFormat { JPEG, PNG };
+
+ImageFormat get_image_format(const torch::Tensor& data) {
   // Check that the input tensor dtype is uint8
   TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
   // Check that the input tensor is 1-dimensional
@@ -20,9 +25,9 @@ torch::Tensor decode_image(const torch::Tensor& data, ImageReadMode mode) {
   const uint8_t png_signature[4] = {137, 80, 78, 71}; // == "\211PNG"
 
   if (memcmp(jpeg_signature, datap, 3) == 0) {
-    return decode_jpeg(data, mode);
+    return ImageFormat::JPEG;
   } else if (memcmp(png_signature, datap, 4) == 0) {
-    return decode_png(data, mode);
+    return ImageFormat::PNG;
   } else {
     TORCH_CHECK(
         false,
@@ -31,5 +36,46 @@ torch::Tensor decode_image(const torch::Tensor& data, ImageReadMode mode) {
   }
 }
 
+} // namespace
+
+torch::Tensor decode_image(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    bool channels_last) {
+  if (get_image_format(data) == ImageFormat::JPEG) {
+    return decode_jpeg(data, mode, 0, 0, channels_last);
+  }
+  return decode_png(data, mode, channels_last);
+}
+
+torch::Tensor decode_image_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode) {
+  if (get_image_format(data) == ImageFormat::JPEG) {
+    return decode_jpeg_out(data, out, mode);
+  }
+  return decode_png_out(data, out, mode);
+}
+
+torch::Tensor decode_image_from_file(
+    const std::string& path,
+    ImageReadMode mode,
+    bool mmap) {
+  auto data = read_file(path, mmap);
+  return decode_image(data, mode);
+}
+
+std::vector<int64_t> get_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width) {
+  if (get_image_format(data) == ImageFormat::JPEG) {
+    return get_jpeg_decoded_shape(data, mode, min_height, min_width);
+  }
+  return get_png_decoded_shape(data, mode);
+}
+
 } // namespace image
 } // namespace vision
@@ -8,7 +8,31 @@ namespace image {
 
 C10_EXPORT torch::Tensor decode_image(
     const torch::Tensor& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    bool channels_last = true);
+
+// Decodes a JPEG or PNG image into out, a [C, H, W] tensor that is either
+// contiguous or channels last. Returns out.
+C10_EXPORT torch::Tensor decode_image_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
     ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED);
 
+// Decodes the JPEG or PNG image stored at path. With mmap, the file is memory
+// mapped rather than read into a buffer first, see read_file
+C10_EXPORT torch::Tensor decode_image_from_file(
+    const std::string& path,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    bool mmap = false);
+
+// Shape [C, H, W] of the decoded image, read from the headers only, so that
+// output buffers can be allocated before decoding. min_height and min_width
+// are those of decode_jpeg and are ignored for PNG images.
+C10_EXPORT std::vector<int64_t> get_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t min_height = 0,
+    int64_t min_width = 0);
+
 } // namespace image
 } // namespace vision
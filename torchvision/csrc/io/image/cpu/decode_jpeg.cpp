@@ -1,84 +1,163 @@
 #include "decode_jpeg.h"
+#include "common_decode.h"
 #include "common_jpeg.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace vision {
 namespace image {
 
 #if !JPEG_FOUND
-torch::Tensor decode_jpeg(const torch::Tensor& data, ImageReadMode mode) {
+torch::Tensor decode_jpeg(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width,
+    bool channels_last,
+    int64_t max_scans) {
   TORCH_CHECK(
       false, "decode_jpeg: torchvision not compiled with libjpeg support");
 }
-#else
-
-using namespace detail;
 
-namespace {
-
-struct torch_jpeg_mgr {
-  struct jpeg_source_mgr pub;
-  const JOCTET* data;
-  size_t len;
-};
+torch::Tensor decode_jpeg_crop(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width,
+    bool channels_last) {
+  TORCH_CHECK(
+      false, "decode_jpeg_crop: torchvision not compiled with libjpeg support");
+}
 
-static void torch_jpeg_init_source(j_decompress_ptr cinfo) {}
+torch::Tensor decode_jpeg_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width) {
+  TORCH_CHECK(
+      false, "decode_jpeg_out: torchvision not compiled with libjpeg support");
+}
 
-static boolean torch_jpeg_fill_input_buffer(j_decompress_ptr cinfo) {
-  // No more data.  Probably an incomplete image;  Raise exception.
-  torch_jpeg_error_ptr myerr = (torch_jpeg_error_ptr)cinfo->err;
-  strcpy(myerr->jpegLastErrorMsg, "Image is incomplete or truncated");
-  longjmp(myerr->setjmp_buffer, 1);
+std::vector<int64_t> get_jpeg_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width) {
+  TORCH_CHECK(
+      false,
+      "get_jpeg_decoded_shape: torchvision not compiled with libjpeg support");
 }
 
-static void torch_jpeg_skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
-  torch_jpeg_mgr* src = (torch_jpeg_mgr*)cinfo->src;
-  if (src->pub.bytes_in_buffer < (size_t)num_bytes) {
-    // Skipping over all of remaining data;  output EOI.
-    src->pub.next_input_byte = EOI_BUFFER;
-    src->pub.bytes_in_buffer = 1;
-  } else {
-    // Skipping over only some of the remaining data.
-    src->pub.next_input_byte += num_bytes;
-    src->pub.bytes_in_buffer -= num_bytes;
-  }
+std::vector<torch::Tensor> decode_jpeg_raw(const torch::Tensor& data) {
+  TORCH_CHECK(
+      false, "decode_jpeg_raw: torchvision not compiled with libjpeg support");
 }
+#else
+
+using namespace detail;
 
-static void torch_jpeg_term_source(j_decompress_ptr cinfo) {}
+namespace {
 
-static void torch_jpeg_set_source_mgr(
+// Sets the output color space matching mode and returns the resulting number
+// of channels, or -1 if libjpeg can not convert the image to that mode
+static int torch_jpeg_set_output_mode(
     j_decompress_ptr cinfo,
-    const unsigned char* data,
-    size_t len) {
-  torch_jpeg_mgr* src;
-  if (cinfo->src == 0) { // if this is first time;  allocate memory
-    cinfo->src = (struct jpeg_source_mgr*)(*cinfo->mem->alloc_small)(
-        (j_common_ptr)cinfo, JPOOL_PERMANENT, sizeof(torch_jpeg_mgr));
-  }
-  src = (torch_jpeg_mgr*)cinfo->src;
-  src->pub.init_source = torch_jpeg_init_source;
-  src->pub.fill_input_buffer = torch_jpeg_fill_input_buffer;
-  src->pub.skip_input_data = torch_jpeg_skip_input_data;
-  src->pub.resync_to_restart = jpeg_resync_to_restart; // default
-  src->pub.term_source = torch_jpeg_term_source;
-  // fill the buffers
-  src->data = (const JOCTET*)data;
-  src->len = len;
-  src->pub.bytes_in_buffer = len;
-  src->pub.next_input_byte = src->data;
+    ImageReadMode mode) {
+  int channels = cinfo->num_components;
+  switch (mode) {
+    case IMAGE_READ_MODE_UNCHANGED:
+      return channels;
+    case IMAGE_READ_MODE_GRAY:
+      if (cinfo->jpeg_color_space != JCS_GRAYSCALE) {
+        cinfo->out_color_space = JCS_GRAYSCALE;
+        channels = 1;
+      }
+      break;
+    case IMAGE_READ_MODE_RGB:
+      if (cinfo->jpeg_color_space != JCS_RGB) {
+        cinfo->out_color_space = JCS_RGB;
+        channels = 3;
+      }
+      break;
+    /*
+     * Libjpeg does not support converting from CMYK to grayscale etc. There
+     * is a way to do this but it involves converting it manually to RGB:
+     * https://github.com/tensorflow/tensorflow/blob/86871065265b04e0db8ca360c046421efb2bdeb4/tensorflow/core/lib/jpeg/jpeg_mem.cc#L284-L313
+     */
+    default:
+      return -1;
+  }
+  jpeg_calc_output_dimensions(cinfo);
+  return channels;
 }
 
-} // namespace
+// Picks the smallest scale M/8 (M <= 8) for which the decoded region of
+// region_height x region_width pixels (in the full size image) still covers
+// min_height x min_width. libjpeg then performs a reduced size IDCT, which
+// skips most of the IDCT and color conversion work.
+static void torch_jpeg_set_min_output_size(
+    j_decompress_ptr cinfo,
+    int64_t min_height,
+    int64_t min_width,
+    int64_t region_height,
+    int64_t region_width) {
+  cinfo->scale_denom = 8;
+  for (unsigned int scale_num = 1; scale_num <= 8; scale_num++) {
+    cinfo->scale_num = scale_num;
+    jpeg_calc_output_dimensions(cinfo);
+    int64_t height = (region_height * cinfo->output_height +
+                      cinfo->image_height - 1) /
+        cinfo->image_height;
+    int64_t width =
+        (region_width * cinfo->output_width + cinfo->image_width - 1) /
+        cinfo->image_width;
+    if (height >= min_height && width >= min_width) {
+      return;
+    }
+  }
+}
 
-torch::Tensor decode_jpeg(const torch::Tensor& data, ImageReadMode mode) {
+// Decodes the window [top, top + height) x [left, left + width) of the image,
+// given in full size image coordinates; a non positive height decodes the
+// whole image. When a downscaled decode is requested, the window is scaled
+// along with the image. The image is decoded into out when it is not null.
+// A positive max_scans stops the decoding of a multi-scan image after that
+// many scans.
+torch::Tensor decode_jpeg_impl(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    int64_t min_height,
+    int64_t min_width,
+    bool channels_last,
+    torch::Tensor* out,
+    int64_t max_scans = 0) {
   // Check that the input tensor dtype is uint8
   TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
   // Check that the input tensor is 1-dimensional
   TORCH_CHECK(
       data.dim() == 1 && data.numel() > 0,
       "Expected a non empty 1-dimensional tensor");
+  TORCH_CHECK(
+      min_height >= 0 && min_width >= 0,
+      "min_height and min_width should be non negative");
+  TORCH_CHECK(max_scans >= 0, "max_scans should be non negative");
 
   struct jpeg_decompress_struct cinfo;
   struct torch_jpeg_error_mgr jerr;
+  // Declared before setjmp, so that they are released if libjpeg fails
+  torch::Tensor tensor;
+  std::vector<uint8_t> row_buffer;
+  std::vector<JSAMPROW> rows;
 
   auto datap = data.data_ptr<uint8_t>();
   // Setup decompression structure
@@ -99,56 +178,340 @@ torch::Tensor decode_jpeg(const torch::Tensor& data, ImageReadMode mode) {
   // read info from header.
   jpeg_read_header(&cinfo, TRUE);
 
-  int channels = cinfo.num_components;
+  int channels = torch_jpeg_set_output_mode(&cinfo, mode);
+  if (channels < 0) {
+    jpeg_destroy_decompress(&cinfo);
+    TORCH_CHECK(false, "The provided mode is not supported for JPEG files");
+  }
+
+  const int64_t image_height = cinfo.image_height;
+  const int64_t image_width = cinfo.image_width;
+  if (height <= 0) {
+    top = 0;
+    left = 0;
+    height = image_height;
+    width = image_width;
+  } else if (
+      top < 0 || left < 0 || width <= 0 || top + height > image_height ||
+      left + width > image_width) {
+    jpeg_destroy_decompress(&cinfo);
+    TORCH_CHECK(
+        false,
+        "Crop box (top=",
+        top,
+        ", left=",
+        left,
+        ", height=",
+        height,
+        ", width=",
+        width,
+        ") is not contained in the image of size ",
+        image_height,
+        "x",
+        image_width);
+  }
 
-  if (mode != IMAGE_READ_MODE_UNCHANGED) {
-    switch (mode) {
-      case IMAGE_READ_MODE_GRAY:
-        if (cinfo.jpeg_color_space != JCS_GRAYSCALE) {
-          cinfo.out_color_space = JCS_GRAYSCALE;
-          channels = 1;
-        }
-        break;
-      case IMAGE_READ_MODE_RGB:
-        if (cinfo.jpeg_color_space != JCS_RGB) {
-          cinfo.out_color_space = JCS_RGB;
-          channels = 3;
+  if (min_height > 0 || min_width > 0) {
+    torch_jpeg_set_min_output_size(
+        &cinfo, min_height, min_width, height, width);
+  }
+
+  // In buffered-image mode, jpeg_start_decompress does not absorb the whole
+  // input of a multi-scan image: the scans are consumed on demand, and any
+  // scan can be output once its data is in the coefficient buffer
+  cinfo.buffered_image = max_scans > 0 && jpeg_has_multiple_scans(&cinfo);
+  jpeg_start_decompress(&cinfo);
+  if (cinfo.buffered_image) {
+    int status;
+    do {
+      status = jpeg_consume_input(&cinfo);
+    } while (status != JPEG_REACHED_EOI &&
+             !(status == JPEG_SCAN_COMPLETED &&
+               cinfo.input_scan_number >= max_scans));
+    jpeg_start_output(&cinfo, cinfo.input_scan_number);
+  }
+
+  // Window in the coordinates of the (possibly downscaled) output
+  const int64_t output_height = cinfo.output_height;
+  const int64_t output_width = cinfo.output_width;
+  const int64_t out_top = top * output_height / image_height;
+  const int64_t out_left = left * output_width / image_width;
+  const int64_t out_bottom = std::min(
+      ((top + height) * output_height + image_height - 1) / image_height,
+      output_height);
+  const int64_t out_right = std::min(
+      ((left + width) * output_width + image_width - 1) / image_width,
+      output_width);
+  const int64_t out_height = std::max<int64_t>(out_bottom - out_top, 1);
+  const int64_t out_width = std::max<int64_t>(out_right - out_left, 1);
+
+  // Columns [xoffset, xoffset + row_width) of each row are decoded
+  JDIMENSION xoffset = 0;
+  JDIMENSION row_width = cinfo.output_width;
+#ifdef LIBJPEG_TURBO_VERSION
+  // libjpeg-turbo only decodes the iMCU columns and rows covering the window.
+  // jpeg_crop_scanline aligns xoffset on an iMCU boundary and widens the row.
+  if (out_width < output_width) {
+    xoffset = out_left;
+    row_width = out_width;
+    jpeg_crop_scanline(&cinfo, &xoffset, &row_width);
+  }
+  if (out_top > 0) {
+    jpeg_skip_scanlines(&cinfo, out_top);
+  }
+#endif
+
+  // libjpeg produces rec_outbuf_height rows at a time at best, they are
+  // requested together rather than one by one
+  const int64_t rows_per_call = std::max(cinfo.rec_outbuf_height, 1);
+  rows.resize(rows_per_call);
+
+  // Interleaved rows are written straight into a channels last output when
+  // they are not wider than the window. Otherwise they go through row_buffer
+  // and are copied (and deinterleaved for a CHW output) from there.
+  bool planar = !channels_last && channels > 1;
+  if (out != nullptr) {
+    auto layout =
+        get_decode_output_layout(*out, channels, out_height, out_width);
+    if (layout == DecodeOutputLayout::Invalid) {
+      jpeg_destroy_decompress(&cinfo);
+      TORCH_CHECK(
+          false, decode_output_error(*out, channels, out_height, out_width));
+    }
+    planar = layout == DecodeOutputLayout::Planar;
+    tensor = planar ? *out : out->permute({1, 2, 0});
+  } else {
+    tensor = planar
+        ? torch::empty({channels, out_height, out_width}, torch::kU8)
+        : torch::empty({out_height, out_width, channels}, torch::kU8);
+  }
+  auto ptr = tensor.data_ptr<uint8_t>();
+  const int64_t stride = out_width * channels;
+  const int64_t row_stride = row_width * channels;
+  const bool read_in_place =
+      !planar && xoffset == out_left && row_width == out_width;
+  if (!read_in_place || cinfo.output_scanline < out_top) {
+    row_buffer.resize(rows_per_call * row_stride);
+  }
+  for (int64_t r = 0; r < rows_per_call; r++) {
+    rows[r] = row_buffer.data() + r * row_stride;
+  }
+
+  // Without libjpeg-turbo, the rows above the window are decoded and dropped
+  while (cinfo.output_scanline < out_top) {
+    jpeg_read_scanlines(
+        &cinfo,
+        rows.data(),
+        std::min<int64_t>(rows_per_call, out_top - cinfo.output_scanline));
+  }
+
+  const int64_t plane_size = out_height * out_width;
+  const int64_t first_column = (out_left - xoffset) * channels;
+  int64_t y = 0;
+  while (y < out_height) {
+    const int64_t num_rows = std::min(rows_per_call, out_height - y);
+    if (read_in_place) {
+      for (int64_t r = 0; r < num_rows; r++) {
+        rows[r] = ptr + (y + r) * stride;
+      }
+    }
+    const int64_t read = jpeg_read_scanlines(&cinfo, rows.data(), num_rows);
+    for (int64_t r = 0; !read_in_place && r < read; r++) {
+      const uint8_t* src = rows[r] + first_column;
+      if (planar) {
+        uint8_t* dst = ptr + (y + r) * out_width;
+        for (int64_t x = 0; x < out_width; x++) {
+          for (int64_t c = 0; c < channels; c++) {
+            dst[c * plane_size + x] = src[x * channels + c];
+          }
         }
-        break;
-      /*
-       * Libjpeg does not support converting from CMYK to grayscale etc. There
-       * is a way to do this but it involves converting it manually to RGB:
-       * https://github.com/tensorflow/tensorflow/blob/86871065265b04e0db8ca360c046421efb2bdeb4/tensorflow/core/lib/jpeg/jpeg_mem.cc#L284-L313
-       */
-      default:
-        jpeg_destroy_decompress(&cinfo);
-        TORCH_CHECK(false, "The provided mode is not supported for JPEG files");
+      } else {
+        std::copy(src, src + stride, ptr + (y + r) * stride);
+      }
     }
+    y += read;
+  }
+
+  if (!cinfo.buffered_image && cinfo.output_scanline == cinfo.output_height) {
+    jpeg_finish_decompress(&cinfo);
+  }
+  // Otherwise the rows below the window, or the scans after max_scans, are
+  // never decoded: destroying the decompression object aborts the decoding
+  jpeg_destroy_decompress(&cinfo);
+  return planar ? tensor : tensor.permute({2, 0, 1});
+}
+
+} // namespace
+
+torch::Tensor decode_jpeg(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width,
+    bool channels_last,
+    int64_t max_scans) {
+  return decode_jpeg_impl(
+      data,
+      mode,
+      0,
+      0,
+      0,
+      0,
+      min_height,
+      min_width,
+      channels_last,
+      nullptr,
+      max_scans);
+}
+
+torch::Tensor decode_jpeg_crop(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width,
+    bool channels_last) {
+  TORCH_CHECK(height > 0, "Crop height should be positive, got ", height);
+  return decode_jpeg_impl(
+      data,
+      mode,
+      top,
+      left,
+      height,
+      width,
+      min_height,
+      min_width,
+      channels_last,
+      nullptr);
+}
+
+torch::Tensor decode_jpeg_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width) {
+  return decode_jpeg_impl(
+      data, mode, 0, 0, 0, 0, min_height, min_width, true, &out);
+}
+
+std::vector<int64_t> get_jpeg_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    int64_t min_height,
+    int64_t min_width) {
+  TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
+  TORCH_CHECK(
+      data.dim() == 1 && data.numel() > 0,
+      "Expected a non empty 1-dimensional tensor");
+
+  struct jpeg_decompress_struct cinfo;
+  struct torch_jpeg_error_mgr jerr;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = torch_jpeg_error_exit;
+  if (setjmp(jerr.setjmp_buffer)) {
+    jpeg_destroy_decompress(&cinfo);
+    TORCH_CHECK(false, jerr.jpegLastErrorMsg);
+  }
+
+  jpeg_create_decompress(&cinfo);
+  torch_jpeg_set_source_mgr(&cinfo, data.data_ptr<uint8_t>(), data.numel());
+  // Only the markers up to the first scan are parsed
+  jpeg_read_header(&cinfo, TRUE);
 
-    jpeg_calc_output_dimensions(&cinfo);
+  int64_t channels = torch_jpeg_set_output_mode(&cinfo, mode);
+  if (channels < 0) {
+    jpeg_destroy_decompress(&cinfo);
+    TORCH_CHECK(false, "The provided mode is not supported for JPEG files");
+  }
+  if (min_height > 0 || min_width > 0) {
+    torch_jpeg_set_min_output_size(
+        &cinfo, min_height, min_width, cinfo.image_height, cinfo.image_width);
+  }
+  jpeg_calc_output_dimensions(&cinfo);
+
+  std::vector<int64_t> shape = {
+      channels, int64_t(cinfo.output_height), int64_t(cinfo.output_width)};
+  jpeg_destroy_decompress(&cinfo);
+  return shape;
+}
+
+std::vector<torch::Tensor> decode_jpeg_raw(const torch::Tensor& data) {
+  TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
+  TORCH_CHECK(
+      data.dim() == 1 && data.numel() > 0,
+      "Expected a non empty 1-dimensional tensor");
+
+  struct jpeg_decompress_struct cinfo;
+  struct torch_jpeg_error_mgr jerr;
+  // Declared before setjmp, so that they are released if libjpeg fails
+  std::vector<torch::Tensor> planes;
+  std::vector<std::vector<JSAMPROW>> rows;
+  std::vector<JSAMPARRAY> components;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = torch_jpeg_error_exit;
+  if (setjmp(jerr.setjmp_buffer)) {
+    jpeg_destroy_decompress(&cinfo);
+    TORCH_CHECK(false, jerr.jpegLastErrorMsg);
   }
 
+  jpeg_create_decompress(&cinfo);
+  torch_jpeg_set_source_mgr(&cinfo, data.data_ptr<uint8_t>(), data.numel());
+  jpeg_read_header(&cinfo, TRUE);
+
+  // The components are returned as stored: no color conversion and no
+  // upsampling of the subsampled ones
+  cinfo.raw_data_out = TRUE;
+  cinfo.out_color_space = cinfo.jpeg_color_space;
   jpeg_start_decompress(&cinfo);
 
-  int height = cinfo.output_height;
-  int width = cinfo.output_width;
+  // jpeg_read_raw_data outputs one iMCU row at a time: v_samp_factor blocks
+  // of DCTSIZE rows for each component. The planes are allocated with whole
+  // blocks so that the rows are decoded in place, and narrowed afterwards.
+  const int num_components = cinfo.num_components;
+  const int64_t imcu_height = cinfo.max_v_samp_factor * DCTSIZE;
+  planes.resize(num_components);
+  rows.resize(num_components);
+  components.resize(num_components);
+  for (int c = 0; c < num_components; c++) {
+    const jpeg_component_info* component = &cinfo.comp_info[c];
+    const int64_t rows_per_imcu = component->v_samp_factor * DCTSIZE;
+    planes[c] = torch::empty(
+        {int64_t(cinfo.total_iMCU_rows) * rows_per_imcu,
+         int64_t(component->width_in_blocks) * DCTSIZE},
+        torch::kU8);
+    rows[c].resize(rows_per_imcu);
+  }
 
-  int stride = width * channels;
-  auto tensor =
-      torch::empty({int64_t(height), int64_t(width), channels}, torch::kU8);
-  auto ptr = tensor.data_ptr<uint8_t>();
-  while (cinfo.output_scanline < cinfo.output_height) {
-    /* jpeg_read_scanlines expects an array of pointers to scanlines.
-     * Here the array is only one element long, but you could ask for
-     * more than one scanline at a time if that's more convenient.
-     */
-    jpeg_read_scanlines(&cinfo, &ptr, 1);
-    ptr += stride;
+  for (int64_t imcu_row = 0; cinfo.output_scanline < cinfo.output_height;
+       imcu_row++) {
+    for (int c = 0; c < num_components; c++) {
+      const int64_t rows_per_imcu = rows[c].size();
+      const int64_t width = planes[c].size(1);
+      uint8_t* ptr = planes[c].data_ptr<uint8_t>() +
+          imcu_row * rows_per_imcu * width;
+      for (int64_t r = 0; r < rows_per_imcu; r++) {
+        rows[c][r] = ptr + r * width;
+      }
+      components[c] = rows[c].data();
+    }
+    jpeg_read_raw_data(&cinfo, components.data(), imcu_height);
   }
 
+  for (int c = 0; c < num_components; c++) {
+    const jpeg_component_info* component = &cinfo.comp_info[c];
+    planes[c] = planes[c]
+                    .narrow(0, 0, component->downsampled_height)
+                    .narrow(1, 0, component->downsampled_width);
+  }
   jpeg_finish_decompress(&cinfo);
   jpeg_destroy_decompress(&cinfo);
-  return tensor.permute({2, 0, 1});
+  return planes;
 }
 
 #endif
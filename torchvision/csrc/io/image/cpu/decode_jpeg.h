@@ -6,9 +6,60 @@
 namespace vision {
 namespace image {
 
+// When min_height or min_width is positive, the image is downscaled by
+// libjpeg while decoding (in the DCT domain), by the largest factor that
+// keeps the decoded image at least min_height x min_width.
+// The returned [C, H, W] tensor is either a view of an HWC tensor
+// (channels_last) or a contiguous tensor, written without any extra pass.
+// When max_scans is positive, a progressive (multi-scan) image is decoded in
+// buffered-image mode from its first max_scans scans only, the following ones
+// are not even entropy decoded: this yields a lower quality preview at a
+// fraction of the cost. Single scan images are always fully decoded.
 C10_EXPORT torch::Tensor decode_jpeg(
     const torch::Tensor& data,
-    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED);
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t min_height = 0,
+    int64_t min_width = 0,
+    bool channels_last = true,
+    int64_t max_scans = 0);
+
+// Decodes only the [top, top + height) x [left, left + width) window of the
+// image. With libjpeg-turbo, the iMCU rows and columns outside of the window
+// are skipped. When min_height or min_width is positive, the window (rather
+// than the whole image) is decoded downscaled to at least that size.
+C10_EXPORT torch::Tensor decode_jpeg_crop(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t min_height = 0,
+    int64_t min_width = 0,
+    bool channels_last = true);
+
+// Decodes the image into out, a [C, H, W] tensor that is either contiguous or
+// channels last, e.g. a slot of a preallocated batch. Returns out.
+C10_EXPORT torch::Tensor decode_jpeg_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t min_height = 0,
+    int64_t min_width = 0);
+
+// Shape [C, H, W] of the image decode_jpeg returns, read from the headers
+C10_EXPORT std::vector<int64_t> get_jpeg_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    int64_t min_height = 0,
+    int64_t min_width = 0);
+
+// Decodes the components of the image as they are stored, e.g. the Y, Cb and
+// Cr planes, without upsampling nor color conversion: subsampled components
+// keep their reduced size. Each plane is a [H, W] view of a buffer that is
+// padded to whole DCT blocks, as libjpeg decodes them in place.
+C10_EXPORT std::vector<torch::Tensor> decode_jpeg_raw(
+    const torch::Tensor& data);
 
 } // namespace image
 } // namespace vision
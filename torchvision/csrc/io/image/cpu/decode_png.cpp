@@ -1,17 +1,74 @@
 #include "decode_png.h"
+#include "common_decode.h"
 #include "common_png.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace vision {
 namespace image {
 
 #if !PNG_FOUND
-torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
+torch::Tensor decode_png(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    bool channels_last,
+    bool allow_16_bits,
+    bool skip_checksums) {
   TORCH_CHECK(
       false, "decode_png: torchvision not compiled with libPNG support");
 }
+
+torch::Tensor decode_png_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode) {
+  TORCH_CHECK(
+      false, "decode_png_out: torchvision not compiled with libPNG support");
+}
 #else
 
-torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
+using namespace detail;
+
+namespace {
+
+// Copies decoded rows of interleaved samples, bytes_per_sample bytes each
+// (16 bits samples are big endian), to dst. Sample c of pixel x of row r goes
+// to dst[r * row_stride + x * pixel_stride + c * channel_stride].
+template <typename dst_t>
+void copy_png_rows(
+    const png_bytep* rows,
+    int64_t num_rows,
+    int64_t width,
+    int64_t channels,
+    int bytes_per_sample,
+    dst_t* dst,
+    int64_t row_stride,
+    int64_t pixel_stride,
+    int64_t channel_stride) {
+  for (int64_t r = 0; r < num_rows; ++r) {
+    const uint8_t* src = rows[r];
+    dst_t* dst_row = dst + r * row_stride;
+    for (int64_t x = 0; x < width; ++x) {
+      for (int64_t c = 0; c < channels; ++c) {
+        const uint8_t* sample = src + (x * channels + c) * bytes_per_sample;
+        dst_row[x * pixel_stride + c * channel_stride] = bytes_per_sample == 2
+            ? dst_t((sample[0] << 8) | sample[1])
+            : dst_t(sample[0]);
+      }
+    }
+  }
+}
+
+// Decodes the image into out when it is not null
+torch::Tensor decode_png_impl(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    bool channels_last,
+    bool allow_16_bits,
+    bool skip_checksums,
+    torch::Tensor* out) {
   // Check that the input tensor dtype is uint8
   TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
   // Check that the input tensor is 1-dimensional
@@ -30,27 +87,49 @@ torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
   }
 
   auto datap = data.accessor<unsigned char, 1>().data();
+  // Declared before setjmp, so that they are released if libpng fails
+  torch::Tensor tensor;
+  std::vector<uint8_t> buffer;
+  std::vector<png_bytep> rows;
 
   if (setjmp(png_jmpbuf(png_ptr)) != 0) {
     png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
     TORCH_CHECK(false, "Internal error.");
   }
-  auto is_png = !png_sig_cmp(datap, 0, 8);
-  TORCH_CHECK(is_png, "Content is not png!")
+  auto is_png = data.numel() >= 8 && !png_sig_cmp(datap, 0, 8);
+  if (!is_png) {
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+    TORCH_CHECK(false, "Content is not png!")
+  }
 
+  // libpng pulls the compressed data through this callback, straight from the
+  // input tensor
   struct Reader {
     png_const_bytep ptr;
+    png_const_bytep end;
   } reader;
   reader.ptr = png_const_bytep(datap) + 8;
+  reader.end = png_const_bytep(datap) + data.numel();
 
   auto read_callback =
       [](png_structp png_ptr, png_bytep output, png_size_t bytes) {
         auto reader = static_cast<Reader*>(png_get_io_ptr(png_ptr));
-        std::copy(reader->ptr, reader->ptr + bytes, output);
+        if (bytes > png_size_t(reader->end - reader->ptr)) {
+          png_error(png_ptr, "Image is incomplete or truncated");
+        }
+        memcpy(output, reader->ptr, bytes);
         reader->ptr += bytes;
       };
   png_set_sig_bytes(png_ptr, 8);
   png_set_read_fn(png_ptr, &reader, read_callback);
+  if (skip_checksums) {
+    // Trusted data: neither the CRC of the chunks nor the Adler-32 checksum
+    // of the zlib stream are verified
+    png_set_crc_action(png_ptr, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+#ifdef PNG_IGNORE_ADLER32
+    png_set_option(png_ptr, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+#endif
+  }
   png_read_info(png_ptr, info_ptr);
 
   png_uint_32 width, height;
@@ -72,6 +151,10 @@ torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
   }
 
   int channels = png_get_channels(png_ptr, info_ptr);
+  // 16 bits images are decoded to 8 bits unless allow_16_bits is set
+  const bool is_16_bits = bit_depth == 16 && allow_16_bits;
+  const int bytes_per_sample = is_16_bits ? 2 : 1;
+  const png_uint_32 opaque = is_16_bits ? 0xFFFF : 0xFF;
 
   if (mode != IMAGE_READ_MODE_UNCHANGED) {
     // TODO: consider supporting PNG_INFO_tRNS
@@ -105,7 +188,7 @@ torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
           }
 
           if (!has_alpha) {
-            png_set_add_alpha(png_ptr, (1 << bit_depth) - 1, PNG_FILLER_AFTER);
+            png_set_add_alpha(png_ptr, opaque, PNG_FILLER_AFTER);
           }
 
           if (has_color) {
@@ -139,7 +222,7 @@ torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
           }
 
           if (!has_alpha) {
-            png_set_add_alpha(png_ptr, (1 << bit_depth) - 1, PNG_FILLER_AFTER);
+            png_set_add_alpha(png_ptr, opaque, PNG_FILLER_AFTER);
           }
           channels = 4;
         }
@@ -148,22 +231,182 @@ torch::Tensor decode_png(const torch::Tensor& data, ImageReadMode mode) {
         png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
         TORCH_CHECK(false, "The provided mode is not supported for PNG files");
     }
+  }
 
-    png_read_update_info(png_ptr, info_ptr);
+  // One sample per byte (or two for 16 bits output), whatever the bit depth
+  if (bit_depth == 16 && !is_16_bits) {
+    png_set_strip_16(png_ptr);
+  } else if (bit_depth < 8) {
+    if (color_type == PNG_COLOR_TYPE_GRAY) {
+      png_set_expand_gray_1_2_4_to_8(png_ptr);
+    } else {
+      // Palette indices
+      png_set_packing(png_ptr);
+    }
   }
+  // Adam7 interlaced images are decoded in 7 passes over the whole image
+  const int passes = png_set_interlace_handling(png_ptr);
+  // The row size follows from the transforms above: png_read_update_info is
+  // not needed, libpng sets them up on the first row it decodes
+  const int64_t bytes = int64_t(width) * channels * bytes_per_sample;
 
-  auto tensor =
-      torch::empty({int64_t(height), int64_t(width), channels}, torch::kU8);
-  auto ptr = tensor.accessor<uint8_t, 3>().data();
-  auto bytes = png_get_rowbytes(png_ptr, info_ptr);
-  for (png_uint_32 i = 0; i < height; ++i) {
-    png_read_row(png_ptr, ptr, nullptr);
-    ptr += bytes;
+  bool planar = !channels_last && channels > 1;
+  if (out != nullptr) {
+    auto layout = get_decode_output_layout(*out, channels, height, width);
+    if (layout == DecodeOutputLayout::Invalid) {
+      png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+      TORCH_CHECK(false, decode_output_error(*out, channels, height, width));
+    }
+    planar = layout == DecodeOutputLayout::Planar;
+  }
+  if (!planar && !is_16_bits) {
+    // Rows are read straight into the HWC tensor, in a single call per pass
+    tensor = out != nullptr
+        ? out->permute({1, 2, 0})
+        : torch::empty(
+              {int64_t(height), int64_t(width), channels}, torch::kU8);
+    auto ptr = tensor.data_ptr<uint8_t>();
+    rows.resize(height);
+    for (png_uint_32 i = 0; i < height; ++i) {
+      rows[i] = ptr + i * bytes;
+    }
+    for (int pass = 0; pass < passes; ++pass) {
+      png_read_rows(png_ptr, rows.data(), nullptr, height);
+    }
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+    return tensor.permute({2, 0, 1});
+  }
+
+  // Otherwise chunks of interleaved rows are read into a small buffer, then
+  // deinterleaved into the planes of a CHW tensor and/or widened to int32 for
+  // 16 bits samples (torch has no uint16 type). Every pass of an interlaced
+  // image touches all the rows, so the buffer holds the whole image then.
+  const png_uint_32 rows_per_chunk =
+      passes > 1 ? height : std::min<png_uint_32>(16, height);
+  const auto dtype = is_16_bits ? torch::kInt32 : torch::kU8;
+  if (out != nullptr) {
+    tensor = *out;
+  } else if (planar) {
+    tensor = torch::empty({channels, int64_t(height), int64_t(width)}, dtype);
+  } else {
+    tensor = torch::empty({int64_t(height), int64_t(width), channels}, dtype);
+  }
+  const int64_t plane_size = int64_t(height) * width;
+  const int64_t row_stride = planar ? width : width * channels;
+  const int64_t pixel_stride = planar ? 1 : channels;
+  const int64_t channel_stride = planar ? plane_size : 1;
+  buffer.resize(rows_per_chunk * bytes);
+  rows.resize(rows_per_chunk);
+  for (png_uint_32 r = 0; r < rows_per_chunk; ++r) {
+    rows[r] = buffer.data() + r * bytes;
+  }
+  for (png_uint_32 y = 0; y < height; y += rows_per_chunk) {
+    png_uint_32 num_rows = std::min(rows_per_chunk, height - y);
+    for (int pass = 0; pass < passes; ++pass) {
+      png_read_rows(png_ptr, rows.data(), nullptr, num_rows);
+    }
+    if (is_16_bits) {
+      copy_png_rows(
+          rows.data(),
+          num_rows,
+          width,
+          channels,
+          bytes_per_sample,
+          tensor.data_ptr<int32_t>() + int64_t(y) * row_stride,
+          row_stride,
+          pixel_stride,
+          channel_stride);
+    } else {
+      copy_png_rows(
+          rows.data(),
+          num_rows,
+          width,
+          channels,
+          bytes_per_sample,
+          tensor.data_ptr<uint8_t>() + int64_t(y) * row_stride,
+          row_stride,
+          pixel_stride,
+          channel_stride);
+    }
   }
   png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-  return tensor.permute({2, 0, 1});
+  return planar ? tensor : tensor.permute({2, 0, 1});
+}
+
+} // namespace
+
+torch::Tensor decode_png(
+    const torch::Tensor& data,
+    ImageReadMode mode,
+    bool channels_last,
+    bool allow_16_bits,
+    bool skip_checksums) {
+  return decode_png_impl(
+      data, mode, channels_last, allow_16_bits, skip_checksums, nullptr);
+}
+
+torch::Tensor decode_png_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode) {
+  return decode_png_impl(data, mode, true, false, false, &out);
 }
 #endif
 
+std::vector<int64_t> get_png_decoded_shape(
+    const torch::Tensor& data,
+    ImageReadMode mode) {
+  TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
+  TORCH_CHECK(
+      data.dim() == 1 && data.numel() > 0,
+      "Expected a non empty 1-dimensional tensor");
+
+  // The IHDR chunk always comes first, right after the 8 bytes signature:
+  // length (4 bytes), "IHDR", width (4), height (4), bit depth, color type
+  const uint8_t png_signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+  const uint8_t* datap = data.data_ptr<uint8_t>();
+  TORCH_CHECK(
+      data.numel() >= 26 && memcmp(datap, png_signature, 8) == 0 &&
+          memcmp(datap + 12, "IHDR", 4) == 0,
+      "Content is not png!");
+  auto read_uint32 = [](const uint8_t* p) {
+    return (int64_t(p[0]) << 24) | (int64_t(p[1]) << 16) |
+        (int64_t(p[2]) << 8) | int64_t(p[3]);
+  };
+  const int64_t width = read_uint32(datap + 16);
+  const int64_t height = read_uint32(datap + 20);
+  const uint8_t color_type = datap[25];
+
+  // Channels per color type: gray, -, RGB, palette (decoded as the palette
+  // indices), gray + alpha, -, RGB + alpha
+  const int64_t color_type_channels[7] = {1, 0, 3, 1, 2, 0, 4};
+  TORCH_CHECK(
+      color_type < 7 && color_type_channels[color_type] > 0,
+      "Invalid PNG color type ",
+      int(color_type));
+
+  int64_t channels = 0;
+  switch (mode) {
+    case IMAGE_READ_MODE_UNCHANGED:
+      channels = color_type_channels[color_type];
+      break;
+    case IMAGE_READ_MODE_GRAY:
+      channels = 1;
+      break;
+    case IMAGE_READ_MODE_GRAY_ALPHA:
+      channels = 2;
+      break;
+    case IMAGE_READ_MODE_RGB:
+      channels = 3;
+      break;
+    case IMAGE_READ_MODE_RGB_ALPHA:
+      channels = 4;
+      break;
+    default:
+      TORCH_CHECK(false, "The provided mode is not supported for PNG files");
+  }
+  return {channels, height, width};
+}
+
 } // namespace image
 } // namespace vision
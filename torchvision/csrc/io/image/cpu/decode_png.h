@@ -6,7 +6,27 @@
 namespace vision {
 namespace image {
 
+// The returned [C, H, W] tensor is either a view of an HWC tensor
+// (channels_last) or a contiguous tensor, written without any extra pass.
+// 16 bits images are decoded to uint8, or to int32 tensors holding the 16 bits
+// samples when allow_16_bits is set. skip_checksums disables the verification
+// of the chunks CRCs and of the zlib Adler-32 checksum, for trusted data.
 C10_EXPORT torch::Tensor decode_png(
+    const torch::Tensor& data,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED,
+    bool channels_last = true,
+    bool allow_16_bits = false,
+    bool skip_checksums = false);
+
+// Decodes the image into out, a [C, H, W] tensor that is either contiguous or
+// channels last, e.g. a slot of a preallocated batch. Returns out.
+C10_EXPORT torch::Tensor decode_png_out(
+    const torch::Tensor& data,
+    torch::Tensor& out,
+    ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED);
+
+// Shape [C, H, W] of the image decode_png returns, read from the IHDR chunk
+C10_EXPORT std::vector<int64_t> get_png_decoded_shape(
     const torch::Tensor& data,
     ImageReadMode mode = IMAGE_READ_MODE_UNCHANGED);
 
@@ -1,13 +1,20 @@
 #include "encode_jpeg.h"
 
+#include "common_encode.h"
 #include "common_jpeg.h"
+#include "parallel_batch.h"
 
 namespace vision {
 namespace image {
 
 #if !JPEG_FOUND
 
-torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
+torch::Tensor encode_jpeg(
+    const torch::Tensor& data,
+    int64_t quality,
+    const std::string& dct_method,
+    const std::string& subsampling,
+    bool optimize_coding) {
   TORCH_CHECK(
       false, "encode_jpeg: torchvision not compiled with libjpeg support");
 }
@@ -16,14 +23,62 @@ torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
 
 using namespace detail;
 
-torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
+namespace {
+
+J_DCT_METHOD get_jpeg_dct_method(const std::string& dct_method) {
+  if (dct_method == "islow") {
+    return JDCT_ISLOW;
+  } else if (dct_method == "ifast") {
+    return JDCT_IFAST;
+  } else if (dct_method == "float") {
+    return JDCT_FLOAT;
+  }
+  TORCH_CHECK(
+      false,
+      "dct_method should be one of islow, ifast or float, got: ",
+      dct_method);
+}
+
+// Returns the horizontal and vertical luma sampling factors of a J:a:b chroma
+// subsampling, the chroma components keep the 1x1 factors
+std::pair<int, int> get_jpeg_sampling_factors(const std::string& subsampling) {
+  if (subsampling == "444") {
+    return {1, 1};
+  } else if (subsampling == "422") {
+    return {2, 1};
+  } else if (subsampling == "420") {
+    return {2, 2};
+  } else if (subsampling == "440") {
+    return {1, 2};
+  } else if (subsampling == "411") {
+    return {4, 1};
+  }
+  TORCH_CHECK(
+      false,
+      "subsampling should be one of 444, 422, 420, 440 or 411, got: ",
+      subsampling);
+}
+
+} // namespace
+
+torch::Tensor encode_jpeg(
+    const torch::Tensor& data,
+    int64_t quality,
+    const std::string& dct_method,
+    const std::string& subsampling,
+    bool optimize_coding) {
   // Define compression structures and error handling
   struct jpeg_compress_struct cinfo;
   struct torch_jpeg_error_mgr jerr;
 
-  // Define buffer to write JPEG information to and its size
-  unsigned long jpegSize = 0;
-  uint8_t* jpegBuf = NULL;
+  // The encoded image is written straight into the output tensor. Its size is
+  // estimated from the raw size, the buffer grows if needed.
+  EncodeOutputBuffer buffer(data.numel() / 8 + 4096);
+  struct torch_jpeg_mgr_dest dest;
+  // Rows passed to libjpeg, and the ones interleaved from images that are not
+  // channels last
+  std::vector<JSAMPROW> rows;
+  std::vector<uint8_t> row_buffer;
 
   cinfo.err = jpeg_std_error(&jerr.pub);
   jerr.pub.error_exit = torch_jpeg_error_exit;
@@ -31,12 +86,9 @@ torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
   /* Establish the setjmp return context for my_error_exit to use. */
   if (setjmp(jerr.setjmp_buffer)) {
     /* If we get here, the JPEG code has signaled an error.
-     * We need to clean up the JPEG object and the buffer.
+     * We need to clean up the JPEG object.
      */
     jpeg_destroy_compress(&cinfo);
-    if (jpegBuf != NULL) {
-      free(jpegBuf);
-    }
 
     TORCH_CHECK(false, (const char*)jerr.jpegLastErrorMsg);
   }
@@ -54,13 +106,15 @@ torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
   int channels = data.size(0);
   int height = data.size(1);
   int width = data.size(2);
-  auto input = data.permute({1, 2, 0}).contiguous();
 
   TORCH_CHECK(
       channels == 1 || channels == 3,
       "The number of channels should be 1 or 3, got: ",
       channels);
 
+  const J_DCT_METHOD dct = get_jpeg_dct_method(dct_method);
+  const auto sampling_factors = get_jpeg_sampling_factors(subsampling);
+
   // Initialize JPEG structure
   jpeg_create_compress(&cinfo);
 
@@ -72,38 +126,79 @@ torch::Tensor encode_jpeg(const torch::Tensor& data, int64_t quality) {
 
   jpeg_set_defaults(&cinfo);
   jpeg_set_quality(&cinfo, quality, TRUE);
+  cinfo.dct_method = dct;
+  cinfo.optimize_coding = optimize_coding;
+  if (channels == 3) {
+    cinfo.comp_info[0].h_samp_factor = sampling_factors.first;
+    cinfo.comp_info[0].v_samp_factor = sampling_factors.second;
+  }
 
-  // Save JPEG output to a buffer
-  jpeg_mem_dest(&cinfo, &jpegBuf, &jpegSize);
+  // Save JPEG output to the output buffer
+  torch_jpeg_set_dest(&cinfo, &dest, &buffer);
 
   // Start JPEG compression
   jpeg_start_compress(&cinfo, TRUE);
 
-  auto stride = width * channels;
-  auto ptr = input.data_ptr<uint8_t>();
+  // Channels last rows are passed to libjpeg in place. The others, e.g. the
+  // rows of a contiguous CHW tensor, are interleaved a few at a time instead
+  // of permuting the whole image.
+  const uint8_t* base = data.data_ptr<uint8_t>();
+  const int64_t channel_stride = data.stride(0);
+  const int64_t row_stride = data.stride(1);
+  const int64_t column_stride = data.stride(2);
+  const bool rows_in_place = column_stride == channels &&
+      (channels == 1 || channel_stride == 1);
+
+  const int64_t rows_per_call = 16;
+  const int64_t row_size = width * channels;
+  rows.resize(rows_per_call);
+  if (!rows_in_place) {
+    row_buffer.resize(rows_per_call * row_size);
+  }
 
   // Encode JPEG file
   while (cinfo.next_scanline < cinfo.image_height) {
-    jpeg_write_scanlines(&cinfo, &ptr, 1);
-    ptr += stride;
+    const int64_t y0 = cinfo.next_scanline;
+    const int64_t num_rows = std::min<int64_t>(rows_per_call, height - y0);
+    for (int64_t i = 0; i < num_rows; i++) {
+      const uint8_t* row = base + (y0 + i) * row_stride;
+      if (rows_in_place) {
+        rows[i] = const_cast<uint8_t*>(row);
+        continue;
+      }
+      uint8_t* out = row_buffer.data() + i * row_size;
+      for (int64_t c = 0; c < channels; c++) {
+        const uint8_t* plane = row + c * channel_stride;
+        for (int64_t x = 0; x < width; x++) {
+          out[x * channels + c] = plane[x * column_stride];
+        }
+      }
+      rows[i] = out;
+    }
+    jpeg_write_scanlines(&cinfo, rows.data(), num_rows);
   }
 
   jpeg_finish_compress(&cinfo);
   jpeg_destroy_compress(&cinfo);
 
-  torch::TensorOptions options = torch::TensorOptions{torch::kU8};
-  auto outTensor = torch::empty({(long)jpegSize}, options);
-
-  // Copy memory from jpeg buffer, since torch cannot get ownership of it via
-  // `from_blob`
-  auto outPtr = outTensor.data_ptr<uint8_t>();
-  std::memcpy(outPtr, jpegBuf, sizeof(uint8_t) * outTensor.numel());
-
-  free(jpegBuf);
-
-  return outTensor;
+  return buffer.finish(dest.size);
 }
 #endif
 
+std::tuple<torch::List<torch::Tensor>, torch::List<std::string>>
+encode_jpeg_batch(
+    const torch::List<torch::Tensor>& data,
+    int64_t quality,
+    const std::string& dct_method,
+    const std::string& subsampling,
+    bool optimize_coding,
+    int64_t num_threads) {
+  return detail::parallel_map_tensors(
+      data, num_threads, [&](const torch::Tensor& input) {
+        return encode_jpeg(
+            input, quality, dct_method, subsampling, optimize_coding);
+      });
+}
+
 } // namespace image
 } // namespace vision
@@ -5,9 +5,27 @@
 namespace vision {
 namespace image {
 
+// dct_method is one of "islow", "ifast" or "float", and subsampling the
+// chroma subsampling of RGB images, one of "444", "422", "420", "440" or
+// "411". Images of any strides are read in place, without a permute copy.
 C10_EXPORT torch::Tensor encode_jpeg(
     const torch::Tensor& data,
-    int64_t quality);
+    int64_t quality,
+    const std::string& dct_method = "islow",
+    const std::string& subsampling = "420",
+    bool optimize_coding = false);
+
+// Encodes a list of images on num_threads threads (at::get_num_threads() when
+// num_threads <= 0). A failed encode yields an empty tensor and a non empty
+// error message, the other images of the batch are still encoded.
+C10_EXPORT std::tuple<torch::List<torch::Tensor>, torch::List<std::string>>
+encode_jpeg_batch(
+    const torch::List<torch::Tensor>& data,
+    int64_t quality,
+    const std::string& dct_method,
+    const std::string& subsampling,
+    bool optimize_coding,
+    int64_t num_threads);
 
 } // namespace image
 } // namespace vision
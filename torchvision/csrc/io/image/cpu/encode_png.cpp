@@ -1,13 +1,27 @@
-#include "encode_jpeg.h"
+#include "encode_png.h"
 
+#include "common_encode.h"
 #include "common_png.h"
+#include "parallel_batch.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if PNG_FOUND
+#include <zlib.h>
+#endif
 
 namespace vision {
 namespace image {
 
 #if !PNG_FOUND
 
-torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
+torch::Tensor encode_png(
+    const torch::Tensor& data,
+    int64_t compression_level,
+    const std::string& filter,
+    const std::string& strategy,
+    int64_t num_threads) {
   TORCH_CHECK(
       false, "encode_png: torchvision not compiled with libpng support");
 }
@@ -16,8 +30,10 @@ torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
 
 namespace {
 
+using namespace detail;
+
 struct torch_mem_encode {
-  char* buffer;
+  EncodeOutputBuffer* buffer;
   size_t size;
 };
 
@@ -46,53 +62,304 @@ void torch_png_write_data(
       (struct torch_mem_encode*)png_get_io_ptr(png_ptr);
   size_t nsize = p->size + length;
 
-  /* allocate or grow buffer */
-  if (p->buffer)
-    p->buffer = (char*)realloc(p->buffer, nsize);
-  else
-    p->buffer = (char*)malloc(nsize);
-
-  if (!p->buffer)
+  /* grow buffer */
+  if (nsize > (size_t)p->buffer->capacity() &&
+      !p->buffer->grow(p->size, nsize)) {
     png_error(png_ptr, "Write Error");
+  }
 
   /* copy new bytes to end of buffer */
-  memcpy(p->buffer + p->size, data, length);
+  memcpy(p->buffer->data() + p->size, data, length);
   p->size += length;
 }
 
-} // namespace
+// Raw bytes of an image band below which it is not worth splitting the
+// encoding: each band restarts the deflate window, at a small cost in size.
+const int64_t kMinPngBandBytes = 1 << 18;
+// Bands are kept below that size so that each fits in a single IDAT chunk
+const int64_t kMaxPngBandBytes = 1 << 28;
+
+// Returns the PNG_FILTER_* flags of a filter name, 0 for libpng's default
+int get_png_filters(const std::string& filter) {
+  if (filter == "default") {
+    return 0;
+  } else if (filter == "none") {
+    return PNG_FILTER_NONE;
+  } else if (filter == "sub") {
+    return PNG_FILTER_SUB;
+  } else if (filter == "up") {
+    return PNG_FILTER_UP;
+  } else if (filter == "avg") {
+    return PNG_FILTER_AVG;
+  } else if (filter == "paeth") {
+    return PNG_FILTER_PAETH;
+  } else if (filter == "adaptive") {
+    return PNG_ALL_FILTERS;
+  }
+  TORCH_CHECK(
+      false,
+      "filter should be one of default, none, sub, up, avg, paeth or ",
+      "adaptive, got: ",
+      filter);
+}
 
-torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
-  // Define compression structures and error handling
-  png_structp png_write;
-  png_infop info_ptr;
-  struct torch_png_error_mgr err_ptr;
+// Returns the zlib strategy of a strategy name, -1 for libpng's default
+int get_zlib_strategy(const std::string& strategy) {
+  if (strategy == "default") {
+    return -1;
+  } else if (strategy == "filtered") {
+    return Z_FILTERED;
+  } else if (strategy == "huffman_only") {
+    return Z_HUFFMAN_ONLY;
+  } else if (strategy == "rle") {
+    return Z_RLE;
+  } else if (strategy == "fixed") {
+    return Z_FIXED;
+  }
+  TORCH_CHECK(
+      false,
+      "strategy should be one of default, filtered, huffman_only, rle or ",
+      "fixed, got: ",
+      strategy);
+}
 
-  // Define output buffer
-  struct torch_mem_encode buf_info;
-  buf_info.buffer = NULL;
-  buf_info.size = 0;
+uint8_t paeth_predictor(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
 
-  /* Establish the setjmp return context for my_error_exit to use. */
-  if (setjmp(err_ptr.setjmp_buffer)) {
-    /* If we get here, the PNG code has signaled an error.
-     * We need to clean up the PNG object and the buffer.
-     */
-    if (info_ptr != NULL) {
-      png_destroy_info_struct(png_write, &info_ptr);
+// Writes row filtered with the given PNG filter type (0 to 4) into out. prev
+// is the previous row of the image, all zeros for the first one.
+void filter_png_row(
+    int type,
+    const uint8_t* row,
+    const uint8_t* prev,
+    int64_t size,
+    int64_t bpp,
+    uint8_t* out) {
+  for (int64_t i = 0; i < size; i++) {
+    const int a = i >= bpp ? row[i - bpp] : 0;
+    const int b = prev[i];
+    const int c = i >= bpp ? prev[i - bpp] : 0;
+    int predictor = 0;
+    switch (type) {
+      case 1:
+        predictor = a;
+        break;
+      case 2:
+        predictor = b;
+        break;
+      case 3:
+        predictor = (a + b) / 2;
+        break;
+      case 4:
+        predictor = paeth_predictor(a, b, c);
+        break;
     }
+    out[i] = uint8_t(row[i] - predictor);
+  }
+}
 
-    if (png_write != NULL) {
-      png_destroy_write_struct(&png_write, NULL);
-    }
+// A band of consecutive rows, filtered and compressed as a raw deflate stream
+// that can be concatenated with the ones of the other bands
+struct PngBand {
+  std::vector<uint8_t> data;
+  uLong adler;
+  int64_t filtered_size;
+};
 
-    if (buf_info.buffer != NULL) {
-      free(buf_info.buffer);
+void deflate_png_band(
+    const uint8_t* image,
+    int64_t row_size,
+    int64_t bpp,
+    int64_t begin,
+    int64_t end,
+    int filters,
+    int level,
+    int strategy,
+    bool last,
+    PngBand& band) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // Negative window bits: no zlib header nor checksum, written by the caller
+  TORCH_CHECK(
+      deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) == Z_OK,
+      "Could not initialize zlib");
+
+  // The filter type byte, then the filtered row
+  std::vector<uint8_t> filtered(row_size + 1), candidate(row_size + 1);
+  std::vector<uint8_t> zeros(row_size, 0);
+  band.filtered_size = (end - begin) * (row_size + 1);
+  band.data.resize(deflateBound(&stream, band.filtered_size) + 16);
+  band.adler = adler32(0L, Z_NULL, 0);
+  stream.next_out = band.data.data();
+  stream.avail_out = band.data.size();
+
+  int ret = Z_OK;
+  for (int64_t y = begin; y < end && ret == Z_OK; y++) {
+    const uint8_t* row = image + y * row_size;
+    const uint8_t* prev = y > 0 ? row - row_size : zeros.data();
+
+    // Same heuristic as libpng: among the allowed filters, the one which
+    // minimizes the sum of the absolute values of the filtered bytes
+    uint64_t best_cost = UINT64_MAX;
+    for (int type = 0; type <= 4; type++) {
+      if (!(filters & (PNG_FILTER_NONE << type))) {
+        continue;
+      }
+      candidate[0] = type;
+      filter_png_row(type, row, prev, row_size, bpp, candidate.data() + 1);
+      if (filters == (PNG_FILTER_NONE << type)) {
+        std::swap(filtered, candidate);
+        break;
+      }
+      uint64_t cost = 0;
+      for (int64_t i = 1; i <= row_size; i++) {
+        cost += std::abs(int(int8_t(candidate[i])));
+      }
+      if (cost < best_cost) {
+        best_cost = cost;
+        std::swap(filtered, candidate);
+      }
     }
 
-    TORCH_CHECK(false, err_ptr.pngLastErrorMsg);
+    band.adler = adler32(band.adler, filtered.data(), filtered.size());
+    stream.next_in = filtered.data();
+    stream.avail_in = filtered.size();
+    ret = deflate(&stream, Z_NO_FLUSH);
+  }
+  if (ret == Z_OK) {
+    // Bands other than the last one end on a byte boundary, without the final
+    // block flag
+    ret = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  }
+  const bool ok = last ? ret == Z_STREAM_END : ret == Z_OK;
+  band.data.resize(stream.total_out);
+  deflateEnd(&stream);
+  TORCH_CHECK(ok, "Could not compress the PNG image");
+}
+
+uint8_t* write_be32(uint8_t* out, uint32_t value) {
+  out[0] = value >> 24;
+  out[1] = value >> 16;
+  out[2] = value >> 8;
+  out[3] = value;
+  return out + 4;
+}
+
+// Writes a chunk whose data has already been written at out + 8
+uint8_t* write_png_chunk(uint8_t* out, const char* type, int64_t size) {
+  write_be32(out, size);
+  memcpy(out + 4, type, 4);
+  const uLong crc = crc32(crc32(0L, Z_NULL, 0), out + 4, size + 4);
+  return write_be32(out + 8 + size, crc);
+}
+
+// Encodes bands of rows of an HWC image on separate threads, and assembles
+// their deflate streams into a single zlib stream, with one IDAT per band.
+torch::Tensor encode_png_parallel(
+    const torch::Tensor& input,
+    int level,
+    int filters,
+    int strategy,
+    int64_t num_bands,
+    int64_t num_threads) {
+  const int64_t height = input.size(0);
+  const int64_t width = input.size(1);
+  const int64_t channels = input.size(2);
+  const int64_t row_size = width * channels;
+  const uint8_t* image = input.data_ptr<uint8_t>();
+
+  // Same defaults as libpng for 8 bits images
+  if (filters == 0) {
+    filters = PNG_ALL_FILTERS;
+  }
+  if (strategy < 0) {
+    strategy = filters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+  }
+
+  const int64_t band_height = (height + num_bands - 1) / num_bands;
+  // No empty band: they could not be flushed
+  num_bands = (height + band_height - 1) / band_height;
+  std::vector<PngBand> bands(num_bands);
+  detail::parallel_for_each(num_bands, num_threads, [&](int64_t i) {
+    const int64_t begin = i * band_height;
+    const int64_t end = std::min(begin + band_height, height);
+    deflate_png_band(
+        image,
+        row_size,
+        channels,
+        begin,
+        end,
+        filters,
+        level,
+        strategy,
+        i == num_bands - 1,
+        bands[i]);
+  });
+
+  uLong adler = adler32(0L, Z_NULL, 0);
+  int64_t size = 8 + (12 + 13) + 12 + 2 + 4;
+  for (const auto& band : bands) {
+    adler = adler32_combine(adler, band.adler, band.filtered_size);
+    size += 12 + band.data.size();
   }
 
+  auto output = torch::empty({size}, torch::kU8);
+  uint8_t* out = output.data_ptr<uint8_t>();
+
+  const uint8_t signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+  memcpy(out, signature, 8);
+  out += 8;
+
+  uint8_t* ihdr = write_be32(write_be32(out + 8, width), height);
+  ihdr[0] = 8;
+  ihdr[1] = channels == 1 ? PNG_COLOR_TYPE_GRAY : PNG_COLOR_TYPE_RGB;
+  ihdr[2] = PNG_COMPRESSION_TYPE_DEFAULT;
+  ihdr[3] = PNG_FILTER_TYPE_DEFAULT;
+  ihdr[4] = PNG_INTERLACE_NONE;
+  out = write_png_chunk(out, "IHDR", 13);
+
+  for (int64_t i = 0; i < num_bands; i++) {
+    uint8_t* chunk_data = out + 8;
+    uint8_t* p = chunk_data;
+    if (i == 0) {
+      // zlib header: deflate with a 32K window, and the level hint that zlib
+      // itself would write
+      const int level_flags = strategy >= Z_HUFFMAN_ONLY || level < 2
+          ? 0
+          : level < 6 ? 1 : level == 6 ? 2 : 3;
+      const int header = (0x78 << 8) | (level_flags << 6);
+      const int check = (31 - header % 31) % 31;
+      *p++ = header >> 8;
+      *p++ = (header & 0xFF) | check;
+    }
+    memcpy(p, bands[i].data.data(), bands[i].data.size());
+    p += bands[i].data.size();
+    if (i == num_bands - 1) {
+      p = write_be32(p, adler);
+    }
+    out = write_png_chunk(out, "IDAT", p - chunk_data);
+  }
+  write_png_chunk(out, "IEND", 0);
+
+  return output;
+}
+
+} // namespace
+
+torch::Tensor encode_png(
+    const torch::Tensor& data,
+    int64_t compression_level,
+    const std::string& filter,
+    const std::string& strategy,
+    int64_t num_threads) {
   // Check that the compression level is between 0 and 9
   TORCH_CHECK(
       compression_level >= 0 && compression_level <= 9,
@@ -118,6 +385,57 @@ torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
       "The number of channels should be 1 or 3, got: ",
       channels);
 
+  const int filters = get_png_filters(filter);
+  const int zlib_strategy = get_zlib_strategy(strategy);
+
+  if (num_threads != 1) {
+    num_threads = detail::resolve_num_threads(num_threads);
+    const int64_t min_bands = (input.numel() - 1) / kMaxPngBandBytes + 1;
+    const int64_t max_bands = std::min<int64_t>(
+        height, std::max<int64_t>(input.numel() / kMinPngBandBytes, 1));
+    const int64_t num_bands =
+        std::min(std::max(num_threads, min_bands), max_bands);
+    if (num_bands > 1) {
+      return encode_png_parallel(
+          input,
+          compression_level,
+          filters,
+          zlib_strategy,
+          num_bands,
+          num_threads);
+    }
+  }
+
+  // Define compression structures and error handling
+  png_structp png_write;
+  png_infop info_ptr;
+  struct torch_png_error_mgr err_ptr;
+
+  // Define output buffer, once the inputs are checked and only for libpng:
+  // the bands above allocate their output at its exact size. The encoded
+  // image is written straight into the output tensor, whose size is
+  // estimated from the raw size.
+  EncodeOutputBuffer buffer(data.numel() / 2 + 1024);
+  struct torch_mem_encode buf_info;
+  buf_info.buffer = &buffer;
+  buf_info.size = 0;
+
+  /* Establish the setjmp return context for my_error_exit to use. */
+  if (setjmp(err_ptr.setjmp_buffer)) {
+    /* If we get here, the PNG code has signaled an error.
+     * We need to clean up the PNG object.
+     */
+    if (info_ptr != NULL) {
+      png_destroy_info_struct(png_write, &info_ptr);
+    }
+
+    if (png_write != NULL) {
+      png_destroy_write_struct(&png_write, NULL);
+    }
+
+    TORCH_CHECK(false, err_ptr.pngLastErrorMsg);
+  }
+
   // Initialize PNG structures
   png_write = png_create_write_struct(
       PNG_LIBPNG_VER_STRING, &err_ptr, torch_png_error, NULL);
@@ -142,6 +460,12 @@ torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
 
   // Set image compression level
   png_set_compression_level(png_write, compression_level);
+  if (filters != 0) {
+    png_set_filter(png_write, PNG_FILTER_TYPE_BASE, filters);
+  }
+  if (zlib_strategy >= 0) {
+    png_set_compression_strategy(png_write, zlib_strategy);
+  }
 
   // Write file header
   png_write_info(png_write, info_ptr);
@@ -161,16 +485,7 @@ torch::Tensor encode_png(const torch::Tensor& data, int64_t compression_level) {
   // Destroy structures
   png_destroy_write_struct(&png_write, &info_ptr);
 
-  torch::TensorOptions options = torch::TensorOptions{torch::kU8};
-  auto outTensor = torch::empty({(long)buf_info.size}, options);
-
-  // Copy memory from png buffer, since torch cannot get ownership of it via
-  // `from_blob`
-  auto outPtr = outTensor.data_ptr<uint8_t>();
-  std::memcpy(outPtr, buf_info.buffer, sizeof(uint8_t) * outTensor.numel());
-  free(buf_info.buffer);
-
-  return outTensor;
+  return buffer.finish(buf_info.size);
 }
 
 #endif
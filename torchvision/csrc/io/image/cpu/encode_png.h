@@ -5,9 +5,17 @@
 namespace vision {
 namespace image {
 
+// filter is one of "default", "none", "sub", "up", "avg", "paeth" or
+// "adaptive", and strategy one of "default", "filtered", "huffman_only",
+// "rle" or "fixed". With num_threads != 1 (at::get_num_threads() when
+// num_threads <= 0), large images are split in bands of rows that are
+// filtered and compressed in parallel.
 C10_EXPORT torch::Tensor encode_png(
     const torch::Tensor& data,
-    int64_t compression_level);
+    int64_t compression_level,
+    const std::string& filter = "default",
+    const std::string& strategy = "default",
+    int64_t num_threads = 1);
 
 } // namespace image
 } // namespace vision
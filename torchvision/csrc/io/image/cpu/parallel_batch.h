@@ -0,0 +1,114 @@
+#pragma once
+
+#include <ATen/Parallel.h>
+#include <torch/types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vision {
+namespace image {
+namespace detail {
+
+// The number of threads used for num_threads <= 0: the one of the intra-op
+// pool, so that torch.set_num_threads, which the DataLoader workers set to 1,
+// also bounds the image ops.
+inline int64_t resolve_num_threads(int64_t num_threads) {
+  if (num_threads <= 0) {
+    return std::max<int64_t>(at::get_num_threads(), 1);
+  }
+  return num_threads;
+}
+
+// Calls fn(i) for every i in [0, size) on up to num_threads threads (see
+// resolve_num_threads when num_threads <= 0). The threads are owned by the
+// call: unlike the intra-op pool, they are not left in a broken state after a
+// fork. The first exception thrown by fn is rethrown once all the threads are
+// joined.
+template <typename fn_t>
+void parallel_for_each(int64_t size, int64_t num_threads, const fn_t& fn) {
+  if (size <= 0) {
+    return;
+  }
+  num_threads = std::min(resolve_num_threads(num_threads), size);
+
+  std::atomic<int64_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    for (int64_t i = next++; i < size; i = next++) {
+      try {
+        fn(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int64_t t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  // The calling thread takes its share of the work as well
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Calls fn on every element of data on up to num_threads threads, and returns
+// the resulting tensors along with one error message per element. A failure
+// on an element does not stop the others: its result is an empty uint8 tensor
+// and its message is non empty.
+template <typename input_t, typename fn_t>
+std::tuple<torch::List<torch::Tensor>, torch::List<std::string>>
+parallel_map_tensors(
+    const torch::List<input_t>& data,
+    int64_t num_threads,
+    const fn_t& fn) {
+  // Work on plain vectors: each thread only touches its own slots
+  std::vector<input_t> inputs = data.vec();
+  std::vector<torch::Tensor> outputs(inputs.size());
+  std::vector<std::string> errors(inputs.size());
+
+  // When called from Python the GIL is released by the op dispatch, the
+  // threads never touch Python objects.
+  parallel_for_each(inputs.size(), num_threads, [&](int64_t i) {
+    try {
+      outputs[i] = fn(inputs[i]);
+    } catch (const c10::Error& e) {
+      outputs[i] = torch::empty({0}, torch::kU8);
+      errors[i] = e.what_without_backtrace();
+    } catch (const std::exception& e) {
+      outputs[i] = torch::empty({0}, torch::kU8);
+      errors[i] = e.what();
+    }
+  });
+
+  torch::List<torch::Tensor> outputs_list;
+  torch::List<std::string> errors_list;
+  outputs_list.reserve(outputs.size());
+  errors_list.reserve(errors.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    outputs_list.push_back(std::move(outputs[i]));
+    errors_list.push_back(std::move(errors[i]));
+  }
+  return std::make_tuple(std::move(outputs_list), std::move(errors_list));
+}
+
+} // namespace detail
+} // namespace image
+} // namespace vision
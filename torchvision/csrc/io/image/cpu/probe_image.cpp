@@ -0,0 +1,226 @@
+#include "probe_image.h"
+
+#include <cstring>
+
+#include "../image_read_mode.h"
+#include "decode_png.h"
+#include "parallel_batch.h"
+
+namespace vision {
+namespace image {
+
+namespace {
+
+uint32_t read_be16(const uint8_t* p) {
+  return (uint32_t(p[0]) << 8) | uint32_t(p[1]);
+}
+
+uint32_t read_be32(const uint8_t* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+      (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+// Returns the orientation tag of the first IFD of an EXIF (TIFF) payload, or
+// 1 (no transformation) when it is absent or malformed
+int64_t get_exif_orientation(const uint8_t* tiff, int64_t size) {
+  if (size < 8) {
+    return 1;
+  }
+  bool little_endian;
+  if (tiff[0] == 'I' && tiff[1] == 'I') {
+    little_endian = true;
+  } else if (tiff[0] == 'M' && tiff[1] == 'M') {
+    little_endian = false;
+  } else {
+    return 1;
+  }
+  auto read16 = [&](int64_t offset) -> uint32_t {
+    const uint8_t* p = tiff + offset;
+    return little_endian ? (uint32_t(p[1]) << 8) | p[0] : read_be16(p);
+  };
+  auto read32 = [&](int64_t offset) -> uint32_t {
+    const uint8_t* p = tiff + offset;
+    return little_endian ? (uint32_t(p[3]) << 24) | (uint32_t(p[2]) << 16) |
+            (uint32_t(p[1]) << 8) | p[0]
+                         : read_be32(p);
+  };
+
+  const int64_t ifd = read32(4);
+  if (ifd + 2 > size) {
+    return 1;
+  }
+  const int64_t num_entries = read16(ifd);
+  for (int64_t i = 0; i < num_entries; i++) {
+    const int64_t entry = ifd + 2 + i * 12;
+    if (entry + 12 > size) {
+      break;
+    }
+    if (read16(entry) == 0x0112) {
+      // A SHORT, stored at the start of the 4 bytes value field
+      const int64_t orientation = read16(entry + 8);
+      return orientation >= 1 && orientation <= 8 ? orientation : 1;
+    }
+  }
+  return 1;
+}
+
+void probe_jpeg(const uint8_t* data, int64_t size, int64_t* info) {
+  info[IMAGE_INFO_INTERLACED] = 0;
+  info[IMAGE_INFO_ORIENTATION] = 1;
+
+  bool found_frame = false;
+  // Markers are walked from the one following SOI up to the first scan
+  int64_t pos = 2;
+  while (pos + 4 <= size) {
+    TORCH_CHECK(data[pos] == 0xFF, "Invalid JPEG marker at offset ", pos);
+    const uint8_t marker = data[pos + 1];
+    if (marker == 0xFF) {
+      // Fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0x01 || marker == 0xD8 ||
+        (marker >= 0xD0 && marker <= 0xD7)) {
+      // Markers without a segment
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xDA || marker == 0xD9) {
+      // SOS or EOI: the headers are over
+      break;
+    }
+
+    const int64_t length = read_be16(data + pos + 2);
+    TORCH_CHECK(
+        length >= 2 && pos + 2 + length <= size,
+        "Image is incomplete or truncated");
+    const uint8_t* segment = data + pos + 4;
+    const int64_t segment_size = length - 2;
+
+    // SOF0 to SOF15, except DHT, JPG and DAC which share the range
+    const bool is_frame = marker >= 0xC0 && marker <= 0xCF &&
+        marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+    if (is_frame && !found_frame) {
+      TORCH_CHECK(segment_size >= 6, "Invalid JPEG frame header");
+      info[IMAGE_INFO_BIT_DEPTH] = segment[0];
+      info[IMAGE_INFO_HEIGHT] = read_be16(segment + 1);
+      info[IMAGE_INFO_WIDTH] = read_be16(segment + 3);
+      info[IMAGE_INFO_CHANNELS] = segment[5];
+      info[IMAGE_INFO_PROGRESSIVE] = marker == 0xC2 || marker == 0xC6 ||
+          marker == 0xCA || marker == 0xCE;
+      found_frame = true;
+    } else if (
+        marker == 0xE1 && segment_size >= 6 &&
+        memcmp(segment, "Exif\0\0", 6) == 0) {
+      info[IMAGE_INFO_ORIENTATION] =
+          get_exif_orientation(segment + 6, segment_size - 6);
+    }
+    pos += 2 + length;
+  }
+  TORCH_CHECK(
+      found_frame,
+      pos + 4 > size ? "Image is incomplete or truncated"
+                     : "Could not find the frame header of the JPEG image");
+}
+
+void probe_png(const torch::Tensor& data, int64_t* info) {
+  // Validates the signature and the IHDR chunk
+  auto shape = get_png_decoded_shape(data, IMAGE_READ_MODE_UNCHANGED);
+
+  const uint8_t* datap = data.data_ptr<uint8_t>();
+  const int64_t size = data.numel();
+  TORCH_CHECK(size >= 33, "Image is incomplete or truncated");
+  info[IMAGE_INFO_CHANNELS] = shape[0];
+  info[IMAGE_INFO_HEIGHT] = shape[1];
+  info[IMAGE_INFO_WIDTH] = shape[2];
+  info[IMAGE_INFO_BIT_DEPTH] = datap[24];
+  info[IMAGE_INFO_PROGRESSIVE] = 0;
+  info[IMAGE_INFO_INTERLACED] = datap[28] != 0;
+  info[IMAGE_INFO_ORIENTATION] = 1;
+
+  // Chunks: length (4 bytes), type (4), data, CRC (4)
+  int64_t pos = 8;
+  while (pos + 8 <= size) {
+    const int64_t length = read_be32(datap + pos);
+    const uint8_t* type = datap + pos + 4;
+    if (memcmp(type, "IDAT", 4) == 0 || memcmp(type, "IEND", 4) == 0) {
+      break;
+    }
+    if (pos + 12 + length > size) {
+      break;
+    }
+    if (memcmp(type, "eXIf", 4) == 0) {
+      info[IMAGE_INFO_ORIENTATION] =
+          get_exif_orientation(datap + pos + 8, length);
+    }
+    pos += 12 + length;
+  }
+}
+
+void probe_image_into(const torch::Tensor& data, int64_t* info) {
+  // Check that the input tensor dtype is uint8
+  TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
+  // Check that the input tensor is 1-dimensional
+  TORCH_CHECK(
+      data.dim() == 1 && data.numel() > 0,
+      "Expected a non empty 1-dimensional tensor");
+
+  const uint8_t* datap = data.data_ptr<uint8_t>();
+  const int64_t size = data.numel();
+
+  const uint8_t jpeg_signature[3] = {255, 216, 255}; // == "\xFF\xD8\xFF"
+  const uint8_t png_signature[4] = {137, 80, 78, 71}; // == "\211PNG"
+
+  if (size >= 3 && memcmp(jpeg_signature, datap, 3) == 0) {
+    probe_jpeg(datap, size, info);
+  } else if (size >= 4 && memcmp(png_signature, datap, 4) == 0) {
+    probe_png(data, info);
+  } else {
+    TORCH_CHECK(
+        false,
+        "Unsupported image file. Only jpeg and png ",
+        "are currently supported.");
+  }
+}
+
+} // namespace
+
+torch::Tensor probe_image(const torch::Tensor& data) {
+  auto info = torch::empty({IMAGE_INFO_NUM_FIELDS}, torch::kLong);
+  probe_image_into(data, info.data_ptr<int64_t>());
+  return info;
+}
+
+std::tuple<torch::Tensor, torch::List<std::string>> probe_image_batch(
+    const torch::List<torch::Tensor>& data,
+    int64_t num_threads) {
+  std::vector<torch::Tensor> inputs(data.begin(), data.end());
+  const int64_t batch_size = inputs.size();
+  auto info =
+      torch::full({batch_size, IMAGE_INFO_NUM_FIELDS}, -1, torch::kLong);
+  std::vector<std::string> errors(batch_size);
+
+  int64_t* info_data = info.data_ptr<int64_t>();
+  detail::parallel_for_each(batch_size, num_threads, [&](int64_t i) {
+    int64_t* row = info_data + i * IMAGE_INFO_NUM_FIELDS;
+    try {
+      probe_image_into(inputs[i], row);
+    } catch (const c10::Error& e) {
+      std::fill(row, row + IMAGE_INFO_NUM_FIELDS, -1);
+      errors[i] = e.what_without_backtrace();
+    } catch (const std::exception& e) {
+      std::fill(row, row + IMAGE_INFO_NUM_FIELDS, -1);
+      errors[i] = e.what();
+    }
+  });
+
+  torch::List<std::string> errors_list;
+  errors_list.reserve(batch_size);
+  for (auto& error : errors) {
+    errors_list.push_back(std::move(error));
+  }
+  return std::make_tuple(info, std::move(errors_list));
+}
+
+} // namespace image
+} // namespace vision
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <torch/types.h>
+
+namespace vision {
+namespace image {
+
+// Fields of the int64 tensor returned by probe_image, in that order. channels
+// is the number of channels of the image decoded with
+// IMAGE_READ_MODE_UNCHANGED, orientation is the EXIF orientation tag (1 when
+// absent).
+enum ImageInfoField : int64_t {
+  IMAGE_INFO_HEIGHT = 0,
+  IMAGE_INFO_WIDTH,
+  IMAGE_INFO_CHANNELS,
+  IMAGE_INFO_BIT_DEPTH,
+  IMAGE_INFO_PROGRESSIVE,
+  IMAGE_INFO_INTERLACED,
+  IMAGE_INFO_ORIENTATION,
+  IMAGE_INFO_NUM_FIELDS
+};
+
+// Reads the metadata of a JPEG or PNG image from its headers only: the JPEG
+// markers up to the first scan, or the PNG chunks up to the first IDAT.
+C10_EXPORT torch::Tensor probe_image(const torch::Tensor& data);
+
+// Probes a list of images on num_threads threads (at::get_num_threads() when
+// num_threads <= 0). Returns a [N, IMAGE_INFO_NUM_FIELDS] tensor and one
+// error message per image; the row of an image that could not be probed is
+// filled with -1 and its message is non empty.
+C10_EXPORT std::tuple<torch::Tensor, torch::List<std::string>>
+probe_image_batch(const torch::List<torch::Tensor>& data, int64_t num_threads);
+
+} // namespace image
+} // namespace vision
@@ -5,6 +5,10 @@
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 namespace vision {
@@ -32,7 +36,89 @@ std::wstring utf8_decode(const std::string& str) {
 } // namespace
 #endif
 
-torch::Tensor read_file(const std::string& filename) {
+namespace {
+
+// Maps the file privately in memory: the pages are those of the page cache
+// until they are written to, writes go to copies and never reach the file. The
+// mapping is released with the last reference to the returned tensor.
+torch::Tensor map_file(const std::string& filename) {
+#ifdef _WIN32
+  auto fileW = utf8_decode(filename);
+  HANDLE file = CreateFileW(
+      fileW.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      NULL,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      NULL);
+  TORCH_CHECK(file != INVALID_HANDLE_VALUE, "Error opening input file");
+  // The size of the file that was opened, not of the one at path now
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    TORCH_CHECK(false, "Error reading the size of input file");
+  }
+  const int64_t size = file_size.QuadPart;
+  if (size <= 0) {
+    CloseHandle(file);
+    TORCH_CHECK(false, "Expected a non empty file");
+  }
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  TORCH_CHECK(mapping != NULL, "Error mapping input file");
+  // The view keeps the mapping alive
+  void* ptr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  CloseHandle(mapping);
+  TORCH_CHECK(ptr != NULL, "Error mapping input file");
+  return torch::from_blob(
+      ptr, {size}, [](void* p) { UnmapViewOfFile(p); }, torch::kU8);
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  TORCH_CHECK(
+      fd >= 0, "[Errno ", errno, "] ", strerror(errno), ": '", filename, "'");
+  // The size of the file that was opened, not of the one at path now
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0) {
+    const int err = errno;
+    close(fd);
+    TORCH_CHECK(
+        false, "[Errno ", err, "] ", strerror(err), ": '", filename, "'");
+  }
+  const int64_t size = stat_buf.st_size;
+  if (size <= 0) {
+    close(fd);
+    TORCH_CHECK(false, "Expected a non empty file");
+  }
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  const int err = errno;
+  // The mapping keeps the file open
+  close(fd);
+  TORCH_CHECK(
+      ptr != MAP_FAILED,
+      "[Errno ",
+      err,
+      "] ",
+      strerror(err),
+      ": '",
+      filename,
+      "'");
+#ifdef MADV_WILLNEED
+  // The whole file is usually read right away, e.g. by a decoder
+  madvise(ptr, size, MADV_WILLNEED);
+#endif
+  return torch::from_blob(
+      ptr, {size}, [size](void* p) { munmap(p, size); }, torch::kU8);
+#endif
+}
+
+} // namespace
+
+torch::Tensor read_file(const std::string& filename, bool mmap) {
+  if (mmap) {
+    return map_file(filename);
+  }
+
 #ifdef _WIN32
   // According to
   // https://docs.microsoft.com/en-us/cpp/c-runtime-library/reference/stat-functions?view=vs-2019,
@@ -40,10 +126,6 @@ torch::Tensor read_file(const std::string& filename) {
   struct __stat64 stat_buf;
   auto fileW = utf8_decode(filename);
   int rc = _wstat64(fileW.c_str(), &stat_buf);
-#else
-  struct stat stat_buf;
-  int rc = stat(filename.c_str(), &stat_buf);
-#endif
   // errno is a variable defined in errno.h
   TORCH_CHECK(
       rc == 0, "[Errno ", errno, "] ", strerror(errno), ": '", filename, "'");
@@ -52,7 +134,6 @@ torch::Tensor read_file(const std::string& filename) {
 
   TORCH_CHECK(size > 0, "Expected a non empty file");
 
-#ifdef _WIN32
   // TODO: Once torch::from_file handles UTF-8 paths correctly, we should move
   // back to use the following implementation since it uses file mapping.
   //   auto data =
@@ -65,11 +146,53 @@ torch::Tensor read_file(const std::string& filename) {
   auto data = torch::empty({size}, torch::kU8);
   auto dataBytes = data.data_ptr<uint8_t>();
 
-  fread(dataBytes, sizeof(uint8_t), size, infile);
+  const size_t read_size = fread(dataBytes, sizeof(uint8_t), size, infile);
   fclose(infile);
+  TORCH_CHECK(read_size == size_t(size), "Unexpected end of input file");
 #else
-  auto data =
-      torch::from_file(filename, /*shared=*/false, /*size=*/size, torch::kU8);
+  // The contents are copied rather than mapped, so that a file truncated
+  // while it is read raises an error instead of SIGBUS
+  int fd = open(filename.c_str(), O_RDONLY);
+  TORCH_CHECK(
+      fd >= 0, "[Errno ", errno, "] ", strerror(errno), ": '", filename, "'");
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0) {
+    const int err = errno;
+    close(fd);
+    TORCH_CHECK(
+        false, "[Errno ", err, "] ", strerror(err), ": '", filename, "'");
+  }
+  const int64_t size = stat_buf.st_size;
+  if (size <= 0) {
+    close(fd);
+    TORCH_CHECK(false, "Expected a non empty file");
+  }
+
+  auto data = torch::empty({size}, torch::kU8);
+  auto dataBytes = data.data_ptr<uint8_t>();
+  int64_t offset = 0;
+  while (offset < size) {
+    const ssize_t n = read(fd, dataBytes + offset, size - offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      const int err = n < 0 ? errno : 0;
+      close(fd);
+      TORCH_CHECK(
+          err == 0,
+          "[Errno ",
+          err,
+          "] ",
+          strerror(err),
+          ": '",
+          filename,
+          "'");
+      TORCH_CHECK(false, "Unexpected end of file: '", filename, "'");
+    }
+    offset += n;
+  }
+  close(fd);
 #endif
 
   return data;
@@ -5,7 +5,11 @@
 namespace vision {
 namespace image {
 
-C10_EXPORT torch::Tensor read_file(const std::string& filename);
+// With mmap, the returned tensor is a private copy-on-write mapping of the file
+// rather than a copy of its contents. Writes to it don't reach the file.
+C10_EXPORT torch::Tensor read_file(
+    const std::string& filename,
+    bool mmap = false);
 
 C10_EXPORT void write_file(const std::string& filename, torch::Tensor& data);
 
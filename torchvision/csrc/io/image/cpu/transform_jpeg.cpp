@@ -0,0 +1,428 @@
+#include "transform_jpeg.h"
+
+#include "common_encode.h"
+#include "common_jpeg.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vision {
+namespace image {
+
+#if !JPEG_FOUND
+
+torch::Tensor crop_jpeg(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width) {
+  TORCH_CHECK(
+      false, "crop_jpeg: torchvision not compiled with libjpeg support");
+}
+
+torch::Tensor transform_jpeg(
+    const torch::Tensor& data,
+    const std::string& transform) {
+  TORCH_CHECK(
+      false, "transform_jpeg: torchvision not compiled with libjpeg support");
+}
+
+#else
+
+using namespace detail;
+
+namespace {
+
+enum class JpegTransform {
+  Crop,
+  HFlip,
+  VFlip,
+  Transpose,
+  Rot90,
+  Rot180,
+  Rot270
+};
+
+JpegTransform get_jpeg_transform(const std::string& transform) {
+  if (transform == "hflip") {
+    return JpegTransform::HFlip;
+  } else if (transform == "vflip") {
+    return JpegTransform::VFlip;
+  } else if (transform == "transpose") {
+    return JpegTransform::Transpose;
+  } else if (transform == "rot90") {
+    return JpegTransform::Rot90;
+  } else if (transform == "rot180") {
+    return JpegTransform::Rot180;
+  } else if (transform == "rot270") {
+    return JpegTransform::Rot270;
+  }
+  TORCH_CHECK(
+      false,
+      "transform should be one of hflip, vflip, transpose, rot90, rot180 or ",
+      "rot270, got: ",
+      transform);
+}
+
+bool is_transposing(JpegTransform transform) {
+  return transform == JpegTransform::Transpose ||
+      transform == JpegTransform::Rot90 || transform == JpegTransform::Rot270;
+}
+
+// Applies the transform to the coefficients of an 8x8 block, stored in natural
+// order (v * DCTSIZE + u for the vertical frequency v and horizontal one u).
+// Mirroring a block negates its odd frequencies along the mirrored axis.
+void transform_block(JpegTransform transform, JCOEFPTR src, JCOEFPTR dst) {
+  for (int v = 0; v < DCTSIZE; v++) {
+    for (int u = 0; u < DCTSIZE; u++) {
+      const int natural = v * DCTSIZE + u;
+      const int transposed = u * DCTSIZE + v;
+      switch (transform) {
+        case JpegTransform::Crop:
+          dst[natural] = src[natural];
+          break;
+        case JpegTransform::HFlip:
+          dst[natural] = (u & 1) ? -src[natural] : src[natural];
+          break;
+        case JpegTransform::VFlip:
+          dst[natural] = (v & 1) ? -src[natural] : src[natural];
+          break;
+        case JpegTransform::Rot180:
+          dst[natural] = ((u + v) & 1) ? -src[natural] : src[natural];
+          break;
+        case JpegTransform::Transpose:
+          dst[natural] = src[transposed];
+          break;
+        case JpegTransform::Rot90:
+          // Transpose, then horizontal flip
+          dst[natural] = (u & 1) ? -src[transposed] : src[transposed];
+          break;
+        case JpegTransform::Rot270:
+          // Transpose, then vertical flip
+          dst[natural] = (v & 1) ? -src[transposed] : src[transposed];
+          break;
+      }
+    }
+  }
+}
+
+int64_t div_round_up(int64_t a, int64_t b) {
+  return (a + b - 1) / b;
+}
+
+// Output window of the transform, in source pixels for a crop
+struct JpegTransformGeometry {
+  int64_t output_width;
+  int64_t output_height;
+  // Top left source iMCU of a crop
+  int64_t imcu_left;
+  int64_t imcu_top;
+  // Source size, in whole iMCUs, of the mirrored axes
+  int64_t imcu_cols;
+  int64_t imcu_rows;
+};
+
+torch::Tensor transform_jpeg_impl(
+    const torch::Tensor& data,
+    JpegTransform transform,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width) {
+  TORCH_CHECK(data.dtype() == torch::kU8, "Expected a torch.uint8 tensor");
+  TORCH_CHECK(
+      data.dim() == 1 && data.numel() > 0,
+      "Expected a non empty 1-dimensional tensor");
+
+  struct jpeg_decompress_struct srcinfo;
+  struct jpeg_compress_struct dstinfo;
+  struct torch_jpeg_error_mgr jerr;
+  // Declared before setjmp, so that they are released if libjpeg fails. The
+  // transcoded image is about the size of the input.
+  EncodeOutputBuffer buffer(data.numel() + 1024);
+  struct torch_jpeg_mgr_dest dest;
+
+  // Zeroed so that destroying an object that was not created yet is a no-op
+  memset(&srcinfo, 0, sizeof(srcinfo));
+  memset(&dstinfo, 0, sizeof(dstinfo));
+  srcinfo.err = jpeg_std_error(&jerr.pub);
+  dstinfo.err = &jerr.pub;
+  jerr.pub.error_exit = torch_jpeg_error_exit;
+  if (setjmp(jerr.setjmp_buffer)) {
+    jpeg_destroy_compress(&dstinfo);
+    jpeg_destroy_decompress(&srcinfo);
+    TORCH_CHECK(false, jerr.jpegLastErrorMsg);
+  }
+
+  jpeg_create_decompress(&srcinfo);
+  jpeg_create_compress(&dstinfo);
+  torch_jpeg_set_source_mgr(&srcinfo, data.data_ptr<uint8_t>(), data.numel());
+  // Comments and application markers (EXIF, ICC profile...) are carried over
+  jpeg_save_markers(&srcinfo, JPEG_COM, 0xFFFF);
+  for (int m = 1; m < 16; m++) {
+    jpeg_save_markers(&srcinfo, JPEG_APP0 + m, 0xFFFF);
+  }
+  jpeg_read_header(&srcinfo, TRUE);
+
+  const int64_t image_width = srcinfo.image_width;
+  const int64_t image_height = srcinfo.image_height;
+  const int64_t imcu_width = srcinfo.max_h_samp_factor * DCTSIZE;
+  const int64_t imcu_height = srcinfo.max_v_samp_factor * DCTSIZE;
+
+  JpegTransformGeometry geometry;
+  geometry.imcu_left = 0;
+  geometry.imcu_top = 0;
+  geometry.imcu_cols = image_width / imcu_width;
+  geometry.imcu_rows = image_height / imcu_height;
+  const int64_t trimmed_width = geometry.imcu_cols * imcu_width;
+  const int64_t trimmed_height = geometry.imcu_rows * imcu_height;
+  switch (transform) {
+    case JpegTransform::Crop:
+      if (top < 0 || left < 0 || height <= 0 || width <= 0 ||
+          top + height > image_height || left + width > image_width) {
+        jpeg_destroy_compress(&dstinfo);
+        jpeg_destroy_decompress(&srcinfo);
+        TORCH_CHECK(
+            false,
+            "Crop box (top=",
+            top,
+            ", left=",
+            left,
+            ", height=",
+            height,
+            ", width=",
+            width,
+            ") is not contained in the image of size ",
+            image_height,
+            "x",
+            image_width);
+      }
+      geometry.imcu_top = top / imcu_height;
+      geometry.imcu_left = left / imcu_width;
+      geometry.output_height = top + height - geometry.imcu_top * imcu_height;
+      geometry.output_width = left + width - geometry.imcu_left * imcu_width;
+      break;
+    case JpegTransform::HFlip:
+      geometry.output_width = trimmed_width;
+      geometry.output_height = image_height;
+      break;
+    case JpegTransform::VFlip:
+      geometry.output_width = image_width;
+      geometry.output_height = trimmed_height;
+      break;
+    case JpegTransform::Rot180:
+      geometry.output_width = trimmed_width;
+      geometry.output_height = trimmed_height;
+      break;
+    case JpegTransform::Transpose:
+      geometry.output_width = image_height;
+      geometry.output_height = image_width;
+      break;
+    case JpegTransform::Rot90:
+      geometry.output_width = trimmed_height;
+      geometry.output_height = image_width;
+      break;
+    case JpegTransform::Rot270:
+      geometry.output_width = image_height;
+      geometry.output_height = trimmed_width;
+      break;
+  }
+  if (geometry.output_width <= 0 || geometry.output_height <= 0) {
+    jpeg_destroy_compress(&dstinfo);
+    jpeg_destroy_decompress(&srcinfo);
+    TORCH_CHECK(
+        false,
+        "The image of size ",
+        image_height,
+        "x",
+        image_width,
+        " is smaller than an iMCU (",
+        imcu_height,
+        "x",
+        imcu_width,
+        ") and can not be transformed losslessly");
+  }
+
+  jvirt_barray_ptr* src_coefs = jpeg_read_coefficients(&srcinfo);
+
+  jpeg_copy_critical_parameters(&srcinfo, &dstinfo);
+  dstinfo.image_width = geometry.output_width;
+  dstinfo.image_height = geometry.output_height;
+  const int num_components = dstinfo.num_components;
+  if (is_transposing(transform)) {
+    // Sampling factors and quantization tables are transposed with the blocks
+    for (int c = 0; c < num_components; c++) {
+      std::swap(
+          dstinfo.comp_info[c].h_samp_factor,
+          dstinfo.comp_info[c].v_samp_factor);
+    }
+    for (int t = 0; t < NUM_QUANT_TBLS; t++) {
+      JQUANT_TBL* table = dstinfo.quant_tbl_ptrs[t];
+      if (table == NULL) {
+        continue;
+      }
+      for (int v = 0; v < DCTSIZE; v++) {
+        for (int u = v + 1; u < DCTSIZE; u++) {
+          std::swap(
+              table->quantval[v * DCTSIZE + u],
+              table->quantval[u * DCTSIZE + v]);
+        }
+      }
+    }
+  }
+  if (srcinfo.progressive_mode) {
+    jpeg_simple_progression(&dstinfo);
+  }
+
+  int max_h_samp_factor = 1, max_v_samp_factor = 1;
+  for (int c = 0; c < num_components; c++) {
+    max_h_samp_factor =
+        std::max(max_h_samp_factor, dstinfo.comp_info[c].h_samp_factor);
+    max_v_samp_factor =
+        std::max(max_v_samp_factor, dstinfo.comp_info[c].v_samp_factor);
+  }
+
+  // The output coefficient arrays, sized as libjpeg expects them: whole MCUs
+  auto dst_coefs = (jvirt_barray_ptr*)(*dstinfo.mem->alloc_small)(
+      (j_common_ptr)&dstinfo,
+      JPOOL_IMAGE,
+      sizeof(jvirt_barray_ptr) * num_components);
+  for (int c = 0; c < num_components; c++) {
+    const jpeg_component_info* component = &dstinfo.comp_info[c];
+    const int64_t width_in_blocks = div_round_up(
+        geometry.output_width * component->h_samp_factor,
+        max_h_samp_factor * DCTSIZE);
+    const int64_t height_in_blocks = div_round_up(
+        geometry.output_height * component->v_samp_factor,
+        max_v_samp_factor * DCTSIZE);
+    dst_coefs[c] = (*dstinfo.mem->request_virt_barray)(
+        (j_common_ptr)&dstinfo,
+        JPOOL_IMAGE,
+        FALSE,
+        div_round_up(width_in_blocks, component->h_samp_factor) *
+            component->h_samp_factor,
+        div_round_up(height_in_blocks, component->v_samp_factor) *
+            component->v_samp_factor,
+        component->v_samp_factor);
+  }
+
+  torch_jpeg_set_dest(&dstinfo, &dest, &buffer);
+  // Realizes the output arrays, they are only read by jpeg_finish_compress
+  jpeg_write_coefficients(&dstinfo, dst_coefs);
+
+  for (jpeg_saved_marker_ptr marker = srcinfo.marker_list; marker != NULL;
+       marker = marker->next) {
+    // libjpeg writes its own Adobe marker when needed
+    if (marker->marker == JPEG_APP0 + 14 && marker->data_length >= 5 &&
+        memcmp(marker->data, "Adobe", 5) == 0) {
+      continue;
+    }
+    jpeg_write_marker(
+        &dstinfo, marker->marker, marker->data, marker->data_length);
+  }
+
+  for (int c = 0; c < num_components; c++) {
+    const jpeg_component_info* src_component = &srcinfo.comp_info[c];
+    const jpeg_component_info* dst_component = &dstinfo.comp_info[c];
+    // Blocks of the source array, padded to whole MCUs
+    const int64_t src_cols =
+        div_round_up(
+            src_component->width_in_blocks, src_component->h_samp_factor) *
+        src_component->h_samp_factor;
+    const int64_t src_rows =
+        div_round_up(
+            src_component->height_in_blocks, src_component->v_samp_factor) *
+        src_component->v_samp_factor;
+    // Source blocks of the whole iMCUs that mirrored axes are flipped within
+    const int64_t mirror_cols =
+        geometry.imcu_cols * src_component->h_samp_factor;
+    const int64_t mirror_rows =
+        geometry.imcu_rows * src_component->v_samp_factor;
+    const int64_t crop_left = geometry.imcu_left * src_component->h_samp_factor;
+    const int64_t crop_top = geometry.imcu_top * src_component->v_samp_factor;
+
+    const int64_t dst_cols =
+        div_round_up(
+            dst_component->width_in_blocks, dst_component->h_samp_factor) *
+        dst_component->h_samp_factor;
+    const int64_t dst_rows =
+        div_round_up(
+            dst_component->height_in_blocks, dst_component->v_samp_factor) *
+        dst_component->v_samp_factor;
+
+    for (int64_t y = 0; y < dst_rows; y++) {
+      JBLOCKROW dst_row = (*dstinfo.mem->access_virt_barray)(
+          (j_common_ptr)&dstinfo, dst_coefs[c], y, 1, TRUE)[0];
+      for (int64_t x = 0; x < dst_cols; x++) {
+        int64_t src_x = x, src_y = y;
+        switch (transform) {
+          case JpegTransform::Crop:
+            src_x = x + crop_left;
+            src_y = y + crop_top;
+            break;
+          case JpegTransform::HFlip:
+            src_x = mirror_cols - 1 - x;
+            break;
+          case JpegTransform::VFlip:
+            src_y = mirror_rows - 1 - y;
+            break;
+          case JpegTransform::Rot180:
+            src_x = mirror_cols - 1 - x;
+            src_y = mirror_rows - 1 - y;
+            break;
+          case JpegTransform::Transpose:
+            src_x = y;
+            src_y = x;
+            break;
+          case JpegTransform::Rot90:
+            src_x = y;
+            src_y = mirror_rows - 1 - x;
+            break;
+          case JpegTransform::Rot270:
+            src_x = mirror_cols - 1 - y;
+            src_y = x;
+            break;
+        }
+        // The padding blocks of the output MCUs may fall outside of the source
+        if (src_x < 0 || src_y < 0 || src_x >= src_cols || src_y >= src_rows) {
+          memset(dst_row[x], 0, sizeof(JBLOCK));
+          continue;
+        }
+        JBLOCKROW src_row = (*srcinfo.mem->access_virt_barray)(
+            (j_common_ptr)&srcinfo, src_coefs[c], src_y, 1, FALSE)[0];
+        transform_block(transform, src_row[src_x], dst_row[x]);
+      }
+    }
+  }
+
+  jpeg_finish_compress(&dstinfo);
+  jpeg_destroy_compress(&dstinfo);
+  jpeg_finish_decompress(&srcinfo);
+  jpeg_destroy_decompress(&srcinfo);
+
+  return buffer.finish(dest.size);
+}
+
+} // namespace
+
+torch::Tensor crop_jpeg(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width) {
+  return transform_jpeg_impl(
+      data, JpegTransform::Crop, top, left, height, width);
+}
+
+torch::Tensor transform_jpeg(
+    const torch::Tensor& data,
+    const std::string& transform) {
+  return transform_jpeg_impl(data, get_jpeg_transform(transform), 0, 0, 0, 0);
+}
+
+#endif
+
+} // namespace image
+} // namespace vision
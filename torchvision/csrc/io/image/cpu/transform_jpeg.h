@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/types.h>
+
+namespace vision {
+namespace image {
+
+// Lossless transformations of a JPEG image, performed on its DCT coefficients
+// without decoding it, as jpegtran does. The result is re-encoded with the
+// same quantization tables and sampling factors.
+
+// Crops the image to [top, top + height) x [left, left + width). top and left
+// are rounded down to a multiple of the iMCU size (8 or 16 pixels, depending
+// on the chroma subsampling), the box grows accordingly.
+C10_EXPORT torch::Tensor crop_jpeg(
+    const torch::Tensor& data,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width);
+
+// transform is one of "hflip", "vflip", "transpose", "rot90", "rot180" or
+// "rot270" (rotations are clockwise). A partial iMCU at an edge that the
+// transform would move to the opposite side can not be transformed losslessly,
+// it is trimmed from the image.
+C10_EXPORT torch::Tensor transform_jpeg(
+    const torch::Tensor& data,
+    const std::string& transform);
+
+} // namespace image
+} // namespace vision
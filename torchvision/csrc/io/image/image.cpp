@@ -14,15 +14,32 @@ PyMODINIT_FUNC PyInit_image(void) {
 namespace vision {
 namespace image {
 
-static auto registry = torch::RegisterOperators()
-                           .op("image::decode_png", &decode_png)
-                           .op("image::encode_png", &encode_png)
-                           .op("image::decode_jpeg", &decode_jpeg)
-                           .op("image::encode_jpeg", &encode_jpeg)
-                           .op("image::read_file", &read_file)
-                           .op("image::write_file", &write_file)
-                           .op("image::decode_image", &decode_image)
-                           .op("image::decode_jpeg_cuda", &decode_jpeg_cuda);
+static auto registry =
+    torch::RegisterOperators()
+        .op("image::decode_png", &decode_png)
+        .op("image::decode_png_out", &decode_png_out)
+        .op("image::encode_png", &encode_png)
+        .op("image::decode_jpeg", &decode_jpeg)
+        .op("image::decode_jpeg_crop", &decode_jpeg_crop)
+        .op("image::decode_jpeg_out", &decode_jpeg_out)
+        .op("image::decode_jpeg_raw", &decode_jpeg_raw)
+        .op("image::encode_jpeg", &encode_jpeg)
+        .op("image::encode_jpeg_batch", &encode_jpeg_batch)
+        .op("image::read_file", &read_file)
+        .op("image::write_file", &write_file)
+        .op("image::decode_image", &decode_image)
+        .op("image::decode_image_out", &decode_image_out)
+        .op("image::get_decoded_shape", &get_decoded_shape)
+        .op("image::decode_jpeg_batch", &decode_jpeg_batch)
+        .op("image::decode_image_batch", &decode_image_batch)
+        .op("image::decode_image_from_file", &decode_image_from_file)
+        .op("image::decode_image_from_file_batch",
+            &decode_image_from_file_batch)
+        .op("image::probe_image", &probe_image)
+        .op("image::probe_image_batch", &probe_image_batch)
+        .op("image::crop_jpeg", &crop_jpeg)
+        .op("image::transform_jpeg", &transform_jpeg)
+        .op("image::decode_jpeg_cuda", &decode_jpeg_cuda);
 
 } // namespace image
 } // namespace vision
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "cpu/decode_batch.h"
 #include "cpu/decode_image.h"
 #include "cpu/decode_jpeg.h"
 #include "cpu/decode_png.h"
 #include "cpu/encode_jpeg.h"
 #include "cpu/encode_png.h"
+#include "cpu/probe_image.h"
 #include "cpu/read_write_file.h"
+#include "cpu/transform_jpeg.h"
 #include "cuda/decode_jpeg_cuda.h"
@@ -2,6 +2,8 @@
 
 #include <regex>
 
+#include "../decoder/util.h"
+
 namespace vision {
 namespace video {
 
@@ -152,9 +154,34 @@ void Video::_getDecoderParams(
 
 } // _get decoder params
 
-Video::Video(std::string videoPath, std::string stream) {
+Video::Video(
+    std::string videoPath,
+    std::string stream,
+    int64_t numThreads,
+    std::string threadType,
+    c10::optional<torch::Tensor> packetIndex) {
   // parse stream information
   current_stream = _parseStream(stream);
+  TORCH_CHECK(numThreads >= 0, "num_threads must be non-negative");
+  int threadMask = Util::parseThreadType(threadType);
+  TORCH_CHECK(
+      threadMask != 0,
+      "Expected one of [auto, frame, slice] for thread_type ",
+      threadType);
+  // kept across the re-initializations done by seek and setCurrentStream
+  params.numThreads = numThreads;
+  params.threadType = threadMask;
+  if (packetIndex.has_value() && packetIndex->numel() > 0) {
+    TORCH_CHECK(
+        packetIndex->dtype() == torch::kByte && packetIndex->dim() == 1 &&
+            packetIndex->is_contiguous(),
+        "Expected a packet index from build_packet_index_from_file");
+    TORCH_CHECK(
+        this->packetIndex.deserialize(
+            packetIndex->data_ptr<uint8_t>(), packetIndex->numel()),
+        "Invalid packet index");
+    params.packetIndex = &this->packetIndex;
+  }
   // note that in the initial call we want to get all streams
   Video::_getDecoderParams(
       0, // video start
@@ -268,9 +295,15 @@ void Video::Seek(double ts) {
       false // read all streams
   );
 
-  // calback and metadata defined in Video.h
-  succeeded = decoder.init(params, std::move(callback), &metadata);
-  LOG(INFO) << "Decoder init at seek " << succeeded << "\n";
+  if (succeeded) {
+    // the input and its codecs stay open, only the position changes
+    succeeded = decoder.seek(params.startOffset, params.endOffset);
+  }
+  if (!succeeded) {
+    // calback and metadata defined in Video.h
+    succeeded = decoder.init(params, std::move(callback), &metadata);
+    LOG(INFO) << "Decoder init at seek " << succeeded << "\n";
+  }
 }
 
 std::tuple<torch::Tensor, double> Video::Next() {
@@ -331,7 +364,12 @@ std::tuple<torch::Tensor, double> Video::Next() {
 
 static auto registerVideo =
     torch::class_<Video>("torchvision", "Video")
-        .def(torch::init<std::string, std::string>())
+        .def(torch::init<
+             std::string,
+             std::string,
+             int64_t,
+             std::string,
+             c10::optional<torch::Tensor>>())
         .def("get_current_stream", &Video::getCurrentStream)
         .def("set_current_stream", &Video::setCurrentStream)
         .def("get_metadata", &Video::getStreamMetadata)
@@ -4,6 +4,7 @@
 
 #include "../decoder/defs.h"
 #include "../decoder/memory_buffer.h"
+#include "../decoder/packet_index.h"
 #include "../decoder/sync_decoder.h"
 
 using namespace ffmpeg;
@@ -18,7 +19,12 @@ struct Video : torch::CustomClassHolder {
       streamsMetadata;
 
  public:
-  Video(std::string videoPath, std::string stream);
+  Video(
+      std::string videoPath,
+      std::string stream,
+      int64_t numThreads,
+      std::string threadType,
+      c10::optional<torch::Tensor> packetIndex);
   std::tuple<std::string, int64_t> getCurrentStream() const;
   c10::Dict<std::string, c10::Dict<std::string, std::vector<double>>>
   getStreamMetadata() const;
@@ -49,6 +55,8 @@ struct Video : torch::CustomClassHolder {
  protected:
   SyncDecoder decoder;
   DecoderParameters params;
+  // used by the decoder through params, if given
+  PacketIndex packetIndex;
 
 }; // struct Video
 
@@ -3,7 +3,9 @@
 #include <Python.h>
 
 #include "../decoder/memory_buffer.h"
+#include "../decoder/packet_index.h"
 #include "../decoder/sync_decoder.h"
+#include "../decoder/util.h"
 
 // If we are in a Windows environment, we need to define
 // initialization functions for the _custom_ops extension
@@ -42,7 +44,9 @@ DecoderParameters getDecoderParams(
     int videoMaxDimension,
     int64_t readAudioStream,
     int audioSamples,
-    int audioChannels) {
+    int audioChannels,
+    int numThreads,
+    int threadType) {
   DecoderParameters params;
   params.headerOnly = getPtsOnly != 0;
   params.seekAccuracy = seekFrameMarginUs;
@@ -50,6 +54,8 @@ DecoderParameters getDecoderParams(
   params.endOffset = videoEndUs;
   params.timeoutMs = decoderTimeoutMs;
   params.preventStaleness = false;
+  params.numThreads = numThreads;
+  params.threadType = threadType;
 
   if (readVideoStream == 1) {
     MediaFormat videoFormat(0);
@@ -74,6 +80,138 @@ DecoderParameters getDecoderParams(
   return params;
 }
 
+// Receives the decoded video frames straight into the output tensor, so that
+// they are neither kept in the messages nor copied afterwards. The tensor is
+// sized from the duration and fps of the stream, and grows geometrically if
+// that estimate falls short.
+class VideoTensorSink : public FrameSink {
+ public:
+  // writes a frame into the next slot of the tensor
+  class FrameStorage : public ByteStorage {
+   public:
+    explicit FrameStorage(VideoTensorSink* sink) : sink_(sink) {}
+    void ensure(size_t n) override {
+      if (!slot_) {
+        slot_ = sink_->nextSlot(n);
+        capacity_ = n;
+      }
+      CHECK_LE(offset_ + length_ + n, capacity_);
+    }
+    uint8_t* writableTail() override {
+      return slot_ + offset_ + length_;
+    }
+    void append(size_t n) override {
+      CHECK_LE(n, tail());
+      length_ += n;
+    }
+    void trim(size_t n) override {
+      CHECK_LE(n, length_);
+      offset_ += n;
+      length_ -= n;
+    }
+    const uint8_t* data() const override {
+      return slot_ + offset_;
+    }
+    size_t length() const override {
+      return length_;
+    }
+    size_t tail() const override {
+      return capacity_ - offset_ - length_;
+    }
+    void clear() override {
+      offset_ = 0;
+      length_ = 0;
+    }
+
+   private:
+    VideoTensorSink* sink_;
+    uint8_t* slot_{nullptr};
+    size_t offset_{0};
+    size_t length_{0};
+    size_t capacity_{0};
+  };
+
+  // sets the number of frames the tensor gets allocated for
+  void reserve(int64_t numFrames) {
+    expectedFrames_ = numFrames;
+  }
+
+  std::unique_ptr<ByteStorage> createFrameStorage() override {
+    return std::make_unique<FrameStorage>(this);
+  }
+
+  void commitFrame(std::unique_ptr<ByteStorage> storage) override {
+    CHECK_EQ(storage->length(), frameBytes_);
+    ++numFrames_;
+  }
+
+  int64_t numFrames() const {
+    return numFrames_;
+  }
+
+  // returns the committed frames, as a [T, H, W, C] tensor
+  torch::Tensor frames(int64_t height, int64_t width, int64_t channels) {
+    CHECK_EQ(frameBytes_, (size_t)(height * width * channels));
+    auto frames = buffer_.narrow(0, 0, numFrames_ * (int64_t)frameBytes_);
+    if (capacity_ - numFrames_ > capacity_ / 4) {
+      // the estimate was far too high, don't hold on to the unused slots
+      frames = frames.clone();
+    }
+    return frames.view({numFrames_, height, width, channels});
+  }
+
+ private:
+  uint8_t* nextSlot(size_t frameBytes) {
+    if (frameBytes_ == 0) {
+      frameBytes_ = frameBytes;
+    }
+    // the decoder scales all frames to the same output format
+    CHECK_EQ(frameBytes, frameBytes_);
+    if (numFrames_ == capacity_) {
+      int64_t capacity = capacity_ == 0
+          ? std::max<int64_t>(expectedFrames_, 16)
+          : capacity_ + capacity_ / 2;
+      auto buffer =
+          torch::empty({capacity * (int64_t)frameBytes_}, torch::kByte);
+      if (numFrames_ > 0) {
+        memcpy(
+            buffer.data_ptr<uint8_t>(),
+            buffer_.data_ptr<uint8_t>(),
+            numFrames_ * frameBytes_);
+      }
+      buffer_ = std::move(buffer);
+      capacity_ = capacity;
+    }
+    return buffer_.data_ptr<uint8_t>() + numFrames_ * frameBytes_;
+  }
+
+  torch::Tensor buffer_;
+  size_t frameBytes_{0};
+  int64_t numFrames_{0};
+  // allocated frames
+  int64_t capacity_{0};
+  int64_t expectedFrames_{0};
+};
+
+// number of frames of the stream within [startUs, endUs], endUs <= 0 means
+// the end of the stream, 0 if the metadata is not enough to tell
+int64_t estimateNumFrames(
+    const DecoderMetadata& header,
+    int64_t startUs,
+    int64_t endUs) {
+  if (header.duration <= 0 || header.fps <= 0) {
+    return 0;
+  }
+  int64_t start = std::max<int64_t>(startUs, 0);
+  int64_t end =
+      endUs > 0 ? std::min<int64_t>(endUs, header.duration) : header.duration;
+  if (end <= start) {
+    return 1;
+  }
+  // one more for the rounding
+  return (int64_t)((end - start) * header.fps / AV_TIME_BASE) + 1;
+}
+
 // returns number of written bytes
 template <typename T>
 size_t fillTensor(
@@ -196,7 +334,17 @@ torch::List<torch::Tensor> readVideo(
     int64_t audioStartPts,
     int64_t audioEndPts,
     int64_t audioTimeBaseNum,
-    int64_t audioTimeBaseDen) {
+    int64_t audioTimeBaseDen,
+    int64_t numThreads,
+    std::string threadType,
+    const c10::optional<torch::Tensor>& packetIndex) {
+  TORCH_CHECK(numThreads >= 0, "numThreads must be non-negative");
+  int threadMask = Util::parseThreadType(threadType);
+  TORCH_CHECK(
+      threadMask != 0,
+      "Expected one of [auto, frame, slice] for threadType ",
+      threadType);
+
   int64_t videoStartUs, videoEndUs;
 
   offsetsToUs(
@@ -226,9 +374,31 @@ torch::List<torch::Tensor> readVideo(
       maxDimension, // maxDimension
       readAudioStream, // readAudioStream
       audioSamples, // audioSamples
-      audioChannels // audioChannels
+      audioChannels, // audioChannels
+      numThreads, // numThreads
+      threadMask // threadType
   );
 
+  // must outlive the decoder
+  VideoTensorSink videoSink;
+  if (getPtsOnly == 0 && readVideoStream == 1) {
+    params.videoSink = &videoSink;
+  }
+
+  // the index as well
+  PacketIndex index;
+  if (packetIndex.has_value() && packetIndex->numel() > 0) {
+    TORCH_CHECK(
+        packetIndex->dtype() == torch::kByte && packetIndex->dim() == 1 &&
+            packetIndex->is_contiguous(),
+        "Expected a packet index from build_packet_index_from_file");
+    TORCH_CHECK(
+        index.deserialize(
+            packetIndex->data_ptr<uint8_t>(), packetIndex->numel()),
+        "Invalid packet index");
+    params.packetIndex = &index;
+  }
+
   SyncDecoder decoder;
   std::vector<DecoderOutputMessage> audioMessages, videoMessages;
   DecoderInCallback callback = nullptr;
@@ -260,6 +430,8 @@ torch::List<torch::Tensor> readVideo(
         audioMetadata = header;
       }
     }
+    videoSink.reserve(
+        estimateNumFrames(videoMetadata, params.startOffset, params.endOffset));
     int res;
     DecoderOutputMessage msg;
     while (0 == (res = decoder.decode(&msg, decoderTimeoutMs))) {
@@ -299,24 +471,22 @@ torch::List<torch::Tensor> readVideo(
       int outWidth = format.width;
       int numChannels = 3; // decoder guarantees the default AV_PIX_FMT_RGB24
 
-      size_t expectedWrittenBytes = 0;
-      if (getPtsOnly == 0) {
-        videoFrame = torch::zeros(
-            {numVideoFrames, outHeight, outWidth, numChannels}, torch::kByte);
-        expectedWrittenBytes =
-            (size_t)numVideoFrames * outHeight * outWidth * numChannels;
-      }
-
       videoFramePts = torch::zeros({numVideoFrames}, torch::kLong);
 
       VLOG(2) << "video duration: " << header.duration
               << ", fps: " << header.fps << ", num: " << header.num
               << ", den: " << header.den << ", num frames: " << numVideoFrames;
 
+      // the messages carry the headers only, fills the pts
       auto numberWrittenBytes = fillVideoTensor(
           videoMessages, videoFrame, videoFramePts, header.num, header.den);
+      CHECK_EQ(numberWrittenBytes, 0);
 
-      CHECK_EQ(numberWrittenBytes, expectedWrittenBytes);
+      if (getPtsOnly == 0) {
+        // the frames are already in place
+        CHECK_EQ(videoSink.numFrames(), numVideoFrames);
+        videoFrame = videoSink.frames(outHeight, outWidth, numChannels);
+      }
 
       videoTimeBase = torch::zeros({2}, torch::kInt);
       int* videoTimeBaseData = videoTimeBase.data_ptr<int>();
@@ -434,7 +604,9 @@ torch::List<torch::Tensor> probeVideo(
       0, // maxDimension
       1, // readAudioStream
       0, // audioSamples
-      0 // audioChannels
+      0, // audioChannels
+      1, // numThreads
+      FF_THREAD_FRAME | FF_THREAD_SLICE // threadType
   );
 
   SyncDecoder decoder;
@@ -582,7 +754,10 @@ torch::List<torch::Tensor> read_video_from_memory(
     int64_t audioStartPts,
     int64_t audioEndPts,
     int64_t audioTimeBaseNum,
-    int64_t audioTimeBaseDen) {
+    int64_t audioTimeBaseDen,
+    int64_t numThreads,
+    std::string threadType,
+    c10::optional<torch::Tensor> packetIndex) {
   return readVideo(
       false,
       input_video,
@@ -604,7 +779,10 @@ torch::List<torch::Tensor> read_video_from_memory(
       audioStartPts,
       audioEndPts,
       audioTimeBaseNum,
-      audioTimeBaseDen);
+      audioTimeBaseDen,
+      numThreads,
+      threadType,
+      packetIndex);
 }
 
 torch::List<torch::Tensor> read_video_from_file(
@@ -626,7 +804,10 @@ torch::List<torch::Tensor> read_video_from_file(
     int64_t audioStartPts,
     int64_t audioEndPts,
     int64_t audioTimeBaseNum,
-    int64_t audioTimeBaseDen) {
+    int64_t audioTimeBaseDen,
+    int64_t numThreads,
+    std::string threadType,
+    c10::optional<torch::Tensor> packetIndex) {
   torch::Tensor dummy_input_video = torch::ones({0});
   return readVideo(
       true,
@@ -649,7 +830,34 @@ torch::List<torch::Tensor> read_video_from_file(
       audioStartPts,
       audioEndPts,
       audioTimeBaseNum,
-      audioTimeBaseDen);
+      audioTimeBaseDen,
+      numThreads,
+      threadType,
+      packetIndex);
+}
+
+torch::Tensor build_packet_index_from_file(std::string videoPath) {
+  PacketIndex index;
+  DecoderParameters params;
+  params.uri = videoPath;
+  params.timeoutMs = decoderTimeoutMs;
+  params.preventStaleness = false;
+  params.headerOnly = true;
+  // no streams get decoded, init builds the index
+  params.packetIndex = &index;
+
+  SyncDecoder decoder;
+  const bool succeeded = decoder.init(params, nullptr, nullptr);
+  decoder.shutdown();
+  TORCH_CHECK(
+      succeeded && !index.empty(),
+      "Could not build the packet index of ",
+      videoPath);
+
+  const auto bytes = index.serialize();
+  auto result = torch::empty({(int64_t)bytes.size()}, torch::kByte);
+  memcpy(result.data_ptr<uint8_t>(), bytes.data(), bytes.size());
+  return result;
 }
 
 torch::List<torch::Tensor> probe_video_from_memory(torch::Tensor input_video) {
@@ -662,8 +870,28 @@ torch::List<torch::Tensor> probe_video_from_file(std::string videoPath) {
 }
 
 TORCH_LIBRARY_FRAGMENT(video_reader, m) {
-  m.def("read_video_from_memory", read_video_from_memory);
-  m.def("read_video_from_file", read_video_from_file);
+  // explicit schemas, so that the trailing arguments are optional
+  m.def(
+      "read_video_from_memory(Tensor input_video, float seekFrameMargin, "
+      "int getPtsOnly, int readVideoStream, int width, int height, "
+      "int minDimension, int maxDimension, int videoStartPts, "
+      "int videoEndPts, int videoTimeBaseNum, int videoTimeBaseDen, "
+      "int readAudioStream, int audioSamples, int audioChannels, "
+      "int audioStartPts, int audioEndPts, int audioTimeBaseNum, "
+      "int audioTimeBaseDen, int numThreads=1, str threadType=\"auto\", "
+      "Tensor? packetIndex=None) -> Tensor[]",
+      read_video_from_memory);
+  m.def(
+      "read_video_from_file(str videoPath, float seekFrameMargin, "
+      "int getPtsOnly, int readVideoStream, int width, int height, "
+      "int minDimension, int maxDimension, int videoStartPts, "
+      "int videoEndPts, int videoTimeBaseNum, int videoTimeBaseDen, "
+      "int readAudioStream, int audioSamples, int audioChannels, "
+      "int audioStartPts, int audioEndPts, int audioTimeBaseNum, "
+      "int audioTimeBaseDen, int numThreads=1, str threadType=\"auto\", "
+      "Tensor? packetIndex=None) -> Tensor[]",
+      read_video_from_file);
+  m.def("build_packet_index_from_file", build_packet_index_from_file);
   m.def("probe_video_from_memory", probe_video_from_memory);
   m.def("probe_video_from_file", probe_video_from_file);
 }
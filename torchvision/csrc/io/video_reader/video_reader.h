@@ -24,7 +24,10 @@ torch::List<torch::Tensor> read_video_from_memory(
     int64_t audioStartPts,
     int64_t audioEndPts,
     int64_t audioTimeBaseNum,
-    int64_t audioTimeBaseDen);
+    int64_t audioTimeBaseDen,
+    int64_t numThreads,
+    std::string threadType,
+    c10::optional<torch::Tensor> packetIndex);
 
 torch::List<torch::Tensor> read_video_from_file(
     std::string videoPath,
@@ -45,7 +48,14 @@ torch::List<torch::Tensor> read_video_from_file(
     int64_t audioStartPts,
     int64_t audioEndPts,
     int64_t audioTimeBaseNum,
-    int64_t audioTimeBaseDen);
+    int64_t audioTimeBaseDen,
+    int64_t numThreads,
+    std::string threadType,
+    c10::optional<torch::Tensor> packetIndex);
+
+// serialized PacketIndex of the file, for read_video_from_file, or for
+// read_video_from_memory with the contents of the file
+torch::Tensor build_packet_index_from_file(std::string videoPath);
 
 torch::List<torch::Tensor> probe_video_from_memory(torch::Tensor input_video);
 
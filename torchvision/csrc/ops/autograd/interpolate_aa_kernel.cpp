@@ -0,0 +1,235 @@
+#include "../interpolate_aa.h"
+
+#include <torch/autograd.h>
+#include <torch/types.h>
+
+namespace vision {
+namespace ops {
+
+namespace {
+
+using interpolate_aa_fn_t =
+    at::Tensor (*)(const at::Tensor&, at::IntArrayRef, bool);
+using interpolate_aa_backward_fn_t = at::Tensor (*)(
+    const at::Tensor&,
+    at::IntArrayRef,
+    at::IntArrayRef,
+    bool);
+
+// All the antialiased interpolation ops share the same signature, only the
+// filter differs: the autograd functions are parametrized by the forward and
+// backward ops of a given filter.
+template <
+    interpolate_aa_fn_t forward_fn,
+    interpolate_aa_backward_fn_t backward_fn>
+class InterpolateAAFunction
+    : public torch::autograd::Function<
+          InterpolateAAFunction<forward_fn, backward_fn>> {
+ public:
+  static torch::autograd::variable_list forward(
+      torch::autograd::AutogradContext* ctx,
+      const torch::autograd::Variable& input,
+      at::IntArrayRef output_size,
+      bool align_corners) {
+    ctx->saved_data["output_size"] = output_size;
+    ctx->saved_data["input_shape"] = input.sizes();
+    ctx->saved_data["align_corners"] = align_corners;
+    at::AutoDispatchBelowADInplaceOrView g;
+    auto result = forward_fn(input, output_size, align_corners);
+    return {result};
+  }
+
+  static torch::autograd::variable_list backward(
+      torch::autograd::AutogradContext* ctx,
+      const torch::autograd::variable_list& grad_output) {
+    // Use data saved in forward
+    auto output_size = ctx->saved_data["output_size"].toIntVector();
+    auto input_shape = ctx->saved_data["input_shape"].toIntVector();
+    auto grad_in = backward_fn(
+        grad_output[0],
+        output_size,
+        input_shape,
+        ctx->saved_data["align_corners"].toBool());
+    return {
+        grad_in, torch::autograd::Variable(), torch::autograd::Variable()};
+  }
+};
+
+// TODO: There should be an easier way to do this
+template <interpolate_aa_backward_fn_t backward_fn>
+class InterpolateAABackwardFunction
+    : public torch::autograd::Function<
+          InterpolateAABackwardFunction<backward_fn>> {
+ public:
+  static torch::autograd::variable_list forward(
+      torch::autograd::AutogradContext* ctx,
+      const torch::autograd::Variable& grad_output,
+      at::IntArrayRef output_size,
+      at::IntArrayRef input_size,
+      bool align_corners) {
+    at::AutoDispatchBelowADInplaceOrView g;
+    auto result =
+        backward_fn(grad_output, output_size, input_size, align_corners);
+    return {result};
+  }
+
+  static torch::autograd::variable_list backward(
+      torch::autograd::AutogradContext* ctx,
+      const torch::autograd::variable_list& grad_output) {
+    TORCH_CHECK(
+        0, "double backwards on antialiased interpolation not supported");
+  }
+};
+
+at::Tensor interpolate_linear_aa_autograd(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners) {
+  return InterpolateAAFunction<
+      _interpolate_linear_aa,
+      detail::_interpolate_linear_aa_backward>::apply(input,
+                                                  output_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_linear_aa_backward_autograd(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  return InterpolateAABackwardFunction<
+      detail::_interpolate_linear_aa_backward>::apply(grad_output,
+                                                  output_size,
+                                                  input_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_bicubic_aa_autograd(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners) {
+  return InterpolateAAFunction<
+      _interpolate_bicubic_aa,
+      detail::_interpolate_bicubic_aa_backward>::apply(input,
+                                                  output_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_bicubic_aa_backward_autograd(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  return InterpolateAABackwardFunction<
+      detail::_interpolate_bicubic_aa_backward>::apply(grad_output,
+                                                  output_size,
+                                                  input_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_box_aa_autograd(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners) {
+  return InterpolateAAFunction<
+      _interpolate_box_aa,
+      detail::_interpolate_box_aa_backward>::apply(input,
+                                                  output_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_box_aa_backward_autograd(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  return InterpolateAABackwardFunction<
+      detail::_interpolate_box_aa_backward>::apply(grad_output,
+                                                  output_size,
+                                                  input_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_hamming_aa_autograd(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners) {
+  return InterpolateAAFunction<
+      _interpolate_hamming_aa,
+      detail::_interpolate_hamming_aa_backward>::apply(input,
+                                                  output_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_hamming_aa_backward_autograd(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  return InterpolateAABackwardFunction<
+      detail::_interpolate_hamming_aa_backward>::apply(grad_output,
+                                                  output_size,
+                                                  input_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_lanczos_aa_autograd(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners) {
+  return InterpolateAAFunction<
+      _interpolate_lanczos_aa,
+      detail::_interpolate_lanczos_aa_backward>::apply(input,
+                                                  output_size,
+                                                  align_corners)[0];
+}
+
+at::Tensor interpolate_lanczos_aa_backward_autograd(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  return InterpolateAABackwardFunction<
+      detail::_interpolate_lanczos_aa_backward>::apply(grad_output,
+                                                  output_size,
+                                                  input_size,
+                                                  align_corners)[0];
+}
+
+} // namespace
+
+TORCH_LIBRARY_IMPL(torchvision, Autograd, m) {
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_linear_aa"),
+      TORCH_FN(interpolate_linear_aa_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_linear_aa_backward"),
+      TORCH_FN(interpolate_linear_aa_backward_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_bicubic_aa"),
+      TORCH_FN(interpolate_bicubic_aa_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_bicubic_aa_backward"),
+      TORCH_FN(interpolate_bicubic_aa_backward_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_box_aa"),
+      TORCH_FN(interpolate_box_aa_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_box_aa_backward"),
+      TORCH_FN(interpolate_box_aa_backward_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_hamming_aa"),
+      TORCH_FN(interpolate_hamming_aa_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_hamming_aa_backward"),
+      TORCH_FN(interpolate_hamming_aa_backward_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_lanczos_aa"),
+      TORCH_FN(interpolate_lanczos_aa_autograd));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_lanczos_aa_backward"),
+      TORCH_FN(interpolate_lanczos_aa_backward_autograd));
+}
+
+} // namespace ops
+} // namespace vision
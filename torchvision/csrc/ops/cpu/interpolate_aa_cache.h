@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/hash.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vision {
+namespace ops {
+namespace detail {
+
+// Identifies the separable indices/weights tables computed for one dimension
+// by the antialiased interpolation kernels. Two calls with the same key
+// produce exactly the same tables, so they can be shared.
+struct InterpAAWeightsKey {
+  int64_t input_size;
+  int64_t output_size;
+  int64_t stride;
+  int64_t ndims;
+  int64_t reshape_dim;
+  bool align_corners;
+  bool antialias;
+  double scale; // -1 when no explicit scale was given
+  int64_t filter; // interpolation filter identifier
+  at::ScalarType dtype;
+
+  bool operator==(const InterpAAWeightsKey& other) const {
+    return input_size == other.input_size &&
+        output_size == other.output_size && stride == other.stride &&
+        ndims == other.ndims && reshape_dim == other.reshape_dim &&
+        align_corners == other.align_corners &&
+        antialias == other.antialias && scale == other.scale &&
+        filter == other.filter && dtype == other.dtype;
+  }
+};
+
+struct InterpAAWeightsKeyHash {
+  size_t operator()(const InterpAAWeightsKey& k) const {
+    return c10::get_hash(
+        k.input_size,
+        k.output_size,
+        k.stride,
+        k.ndims,
+        k.reshape_dim,
+        k.align_corners,
+        k.antialias,
+        k.scale,
+        k.filter,
+        static_cast<int>(k.dtype));
+  }
+};
+
+struct InterpAAWeights {
+  // ids_min, ids_size, ids_stride, weights and weights indices, as consumed
+  // by the TensorIterator of the separable kernel
+  std::vector<at::Tensor> tensors;
+  // Effective interpolation size (depends on the scale)
+  int interp_size;
+};
+
+// Bounded, thread-safe LRU cache of the indices/weights tables. The cached
+// tensors are never written to after being computed, hence they can be
+// handed out to several threads concurrently.
+class InterpAAWeightsCache {
+ public:
+  explicit InterpAAWeightsCache(size_t capacity) : capacity_(capacity) {}
+
+  template <typename compute_fn_t>
+  InterpAAWeights get(const InterpAAWeightsKey& key, compute_fn_t compute_fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = map_.find(key);
+      if (it != map_.end()) {
+        // Move the entry to the front (most recently used)
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+      }
+    }
+
+    // Compute outside of the lock: concurrent misses on the same key only
+    // waste some work, they never produce different tables.
+    InterpAAWeights value = compute_fn();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || map_.count(key) != 0) {
+      return value;
+    }
+    entries_.emplace_front(key, value);
+    map_[key] = entries_.begin();
+    while (map_.size() > capacity_) {
+      map_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    return value;
+  }
+
+ private:
+  using Entry = std::pair<InterpAAWeightsKey, InterpAAWeights>;
+
+  std::mutex mutex_;
+  const size_t capacity_;
+  std::list<Entry> entries_;
+  std::unordered_map<
+      InterpAAWeightsKey,
+      std::list<Entry>::iterator,
+      InterpAAWeightsKeyHash>
+      map_;
+};
+
+// Process-wide cache shared by the CPU antialiased interpolation kernels
+inline InterpAAWeightsCache& interp_aa_weights_cache() {
+  static InterpAAWeightsCache cache(/*capacity=*/256);
+  return cache;
+}
+
+} // namespace detail
+} // namespace ops
+} // namespace vision
@@ -1,12 +1,16 @@
+#include <ATen/Parallel.h>
 #include <ATen/TypeDefault.h>
 #include <ATen/native/IndexingUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/UpSample.h>
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
 #include <torch/library.h>
 
+#include "interpolate_aa_cache.h"
+
 // Code temporary is in torchvision before merging it to PyTorch
 namespace at {
 namespace native {
@@ -14,6 +18,17 @@ namespace internal_upsample {
 
 using scale_t = std::vector<c10::optional<double>>;
 
+// Identifiers of the interpolation filters, part of the weights cache key
+enum class InterpFilter : int64_t {
+  Linear = 0,
+  Cubic = 1,
+  Box = 2,
+  Hamming = 3,
+  Lanczos = 4
+};
+
+static constexpr double kPi = 3.14159265358979323846;
+
 template <typename scalar_t, typename index_t>
 static inline scalar_t interpolate_aa_single_dim_zero_strides(
     char* src,
@@ -150,11 +165,15 @@ struct HelperInterpBase {
       int64_t reshape_dim,
       bool align_corners,
       scalar_t scale,
+      bool antialias,
       int& in_out_interp_size,
       filter_fn_t filter_fn) {
+    // Without antialiasing the filter is not stretched when downsampling:
+    // for the linear filter this is the regular bilinear interpolation
+    bool stretch = antialias && (scale >= 1.0);
     int interp_size = in_out_interp_size;
     scalar_t support =
-        (scale >= 1.0) ? (interp_size * 0.5) * scale : interp_size * 0.5;
+        stretch ? (interp_size * 0.5) * scale : interp_size * 0.5;
     interp_size = (int)ceilf(support) * 2 + 1;
 
     // return interp_size
@@ -187,7 +206,7 @@ struct HelperInterpBase {
           empty(new_shape, CPU(c10::CppTypeToScalarType<index_t>())));
     }
 
-    scalar_t center, total_w, invscale = (scale >= 1.0) ? 1.0 / scale : 1.0;
+    scalar_t center, total_w, invscale = stretch ? 1.0 / scale : 1.0;
     index_t zero = static_cast<index_t>(0);
     int64_t* idx_ptr_xmin = output[0].data_ptr<index_t>();
     int64_t* idx_ptr_size = output[1].data_ptr<index_t>();
@@ -229,9 +248,43 @@ struct HelperInterpBase {
   }
 };
 
+// Filters which only differ by their support and weights function: Derived
+// provides interp_size and _filter. They are only used with antialiasing.
+template <typename Derived, typename index_t, typename scalar_t>
+struct HelperInterpAA : public HelperInterpBase<index_t, scalar_t> {
+  static inline std::vector<Tensor> compute_indices_weights(
+      int64_t input_size,
+      int64_t output_size,
+      int64_t stride,
+      int64_t ndims,
+      int64_t reshape_dim,
+      bool align_corners,
+      const c10::optional<double> opt_scale,
+      bool antialias,
+      int& out_interp_size) {
+    TORCH_INTERNAL_ASSERT(antialias);
+    scalar_t scale = area_pixel_compute_scale<scalar_t>(
+        input_size, output_size, align_corners, opt_scale);
+
+    out_interp_size = Derived::interp_size;
+    return HelperInterpBase<index_t, scalar_t>::_compute_indices_weights_aa(
+        input_size,
+        output_size,
+        stride,
+        ndims,
+        reshape_dim,
+        align_corners,
+        scale,
+        antialias,
+        out_interp_size,
+        Derived::_filter);
+  }
+};
+
 template <typename index_t, typename scalar_t>
 struct HelperInterpLinear : public HelperInterpBase<index_t, scalar_t> {
   static const int interp_size = 2;
+  static const InterpFilter filter = InterpFilter::Linear;
 
   // taken from
   // https://github.com/python-pillow/Pillow/blob/6812205f18ca4ef54372e87e1a13ce4a859434df/
@@ -256,7 +309,6 @@ struct HelperInterpLinear : public HelperInterpBase<index_t, scalar_t> {
       const c10::optional<double> opt_scale,
       bool antialias,
       int& out_interp_size) {
-    TORCH_INTERNAL_ASSERT(antialias);
     scalar_t scale = area_pixel_compute_scale<scalar_t>(
         input_size, output_size, align_corners, opt_scale);
 
@@ -269,6 +321,7 @@ struct HelperInterpLinear : public HelperInterpBase<index_t, scalar_t> {
         reshape_dim,
         align_corners,
         scale,
+        antialias,
         out_interp_size,
         _filter);
   }
@@ -277,6 +330,7 @@ struct HelperInterpLinear : public HelperInterpBase<index_t, scalar_t> {
 template <typename index_t, typename scalar_t>
 struct HelperInterpCubic : public HelperInterpBase<index_t, scalar_t> {
   static const int interp_size = 4;
+  static const InterpFilter filter = InterpFilter::Cubic;
 
   static inline std::vector<Tensor> compute_indices_weights(
       int64_t input_size,
@@ -301,6 +355,7 @@ struct HelperInterpCubic : public HelperInterpBase<index_t, scalar_t> {
         reshape_dim,
         align_corners,
         scale,
+        antialias,
         out_interp_size,
         _filter);
   }
@@ -325,6 +380,128 @@ struct HelperInterpCubic : public HelperInterpBase<index_t, scalar_t> {
   }
 };
 
+template <typename index_t, typename scalar_t>
+struct HelperInterpBox
+    : public HelperInterpAA<
+          HelperInterpBox<index_t, scalar_t>,
+          index_t,
+          scalar_t> {
+  static const int interp_size = 1;
+  static const InterpFilter filter = InterpFilter::Box;
+
+  // taken from
+  // https://github.com/python-pillow/Pillow/blob/6812205f18ca4ef54372e87e1a13ce4a859434df/
+  // src/libImaging/Resample.c (box_filter)
+  static inline scalar_t _filter(scalar_t x) {
+    if (x > -0.5 && x <= 0.5) {
+      return 1.0;
+    }
+    return 0.0;
+  }
+};
+
+template <typename index_t, typename scalar_t>
+struct HelperInterpHamming
+    : public HelperInterpAA<
+          HelperInterpHamming<index_t, scalar_t>,
+          index_t,
+          scalar_t> {
+  static const int interp_size = 2;
+  static const InterpFilter filter = InterpFilter::Hamming;
+
+  // taken from
+  // https://github.com/python-pillow/Pillow/blob/6812205f18ca4ef54372e87e1a13ce4a859434df/
+  // src/libImaging/Resample.c (hamming_filter)
+  static inline scalar_t _filter(scalar_t x) {
+    if (x < 0.0) {
+      x = -x;
+    }
+    if (x == 0.0) {
+      return 1.0;
+    }
+    if (x >= 1.0) {
+      return 0.0;
+    }
+    x = x * kPi;
+    return std::sin(x) / x * (0.54 + 0.46 * std::cos(x));
+  }
+};
+
+template <typename index_t, typename scalar_t>
+struct HelperInterpLanczos
+    : public HelperInterpAA<
+          HelperInterpLanczos<index_t, scalar_t>,
+          index_t,
+          scalar_t> {
+  static const int interp_size = 6;
+  static const InterpFilter filter = InterpFilter::Lanczos;
+
+  static inline scalar_t _sinc(scalar_t x) {
+    if (x == 0.0) {
+      return 1.0;
+    }
+    x = x * kPi;
+    return std::sin(x) / x;
+  }
+
+  // taken from
+  // https://github.com/python-pillow/Pillow/blob/6812205f18ca4ef54372e87e1a13ce4a859434df/
+  // src/libImaging/Resample.c (lanczos_filter)
+  static inline scalar_t _filter(scalar_t x) {
+    // truncated sinc
+    if (-3.0 <= x && x < 3.0) {
+      return _sinc(x) * _sinc(x / 3);
+    }
+    return 0.0;
+  }
+};
+
+// Indices and weights only depend on the geometry of the interpolated
+// dimension, so they are looked up in a cache before being computed.
+// Returns the tables along with the effective interpolation size.
+template <
+    typename index_t,
+    typename scalar_t,
+    template <typename, typename>
+    class F>
+static inline vision::ops::detail::InterpAAWeights get_indices_weights_aa(
+    int64_t input_size,
+    int64_t output_size,
+    int64_t stride,
+    int64_t ndims,
+    int64_t reshape_dim,
+    bool align_corners,
+    const c10::optional<double> opt_scale,
+    bool antialias) {
+  vision::ops::detail::InterpAAWeightsKey key{
+      input_size,
+      output_size,
+      stride,
+      ndims,
+      reshape_dim,
+      align_corners,
+      antialias,
+      opt_scale.has_value() ? opt_scale.value() : -1.0,
+      static_cast<int64_t>(F<index_t, scalar_t>::filter),
+      c10::CppTypeToScalarType<scalar_t>::value};
+
+  return vision::ops::detail::interp_aa_weights_cache().get(
+      key, [&]() -> vision::ops::detail::InterpAAWeights {
+        int interp_size = F<index_t, scalar_t>::interp_size;
+        auto tensors = F<index_t, scalar_t>::compute_indices_weights(
+            input_size,
+            output_size,
+            stride,
+            ndims,
+            reshape_dim,
+            align_corners,
+            opt_scale,
+            antialias,
+            interp_size);
+        return {std::move(tensors), interp_size};
+      });
+}
+
 template <
     typename index_t,
     int out_ndims,
@@ -346,7 +523,6 @@ void _ti_separable_upsample_generic_Nd_kernel_impl_single_dim(
   TORCH_INTERNAL_ASSERT(
       shape.size() == oshape.size() && shape.size() == 2 + out_ndims);
   TORCH_INTERNAL_ASSERT(strides.size() == 2 + out_ndims);
-  TORCH_INTERNAL_ASSERT(antialias);
 
   for (int i = 0; i < out_ndims; i++) {
     shape[i + 2] = oshape[i + 2];
@@ -357,30 +533,20 @@ void _ti_separable_upsample_generic_Nd_kernel_impl_single_dim(
   std::vector<std::vector<Tensor>> indices_weights;
 
   int interp_size = F<index_t, float>::interp_size;
-  auto input_scalar_type = input.scalar_type();
 
-  if (interp_size == 1 && input_scalar_type == at::ScalarType::Byte) {
-    // nearest also supports uint8 tensor, but we have to use float
-    // with compute_indices_weights
-    input_scalar_type = at::ScalarType::Float;
-  }
-
-  AT_DISPATCH_FLOATING_TYPES_AND(
-      at::ScalarType::Byte,
-      input_scalar_type,
-      "compute_indices_weights_generic",
-      [&] {
-        indices_weights.emplace_back(
-            F<index_t, scalar_t>::compute_indices_weights(
-                input.size(interp_dim),
-                oshape[interp_dim],
-                input.stride(interp_dim) * input.element_size(),
-                input.dim(),
-                interp_dim,
-                align_corners,
-                scales[interp_dim - 2],
-                antialias,
-                interp_size));
+  AT_DISPATCH_FLOATING_TYPES(
+      input.scalar_type(), "compute_indices_weights_generic", [&] {
+        auto weights = get_indices_weights_aa<index_t, scalar_t, F>(
+            input.size(interp_dim),
+            oshape[interp_dim],
+            input.stride(interp_dim) * input.element_size(),
+            input.dim(),
+            interp_dim,
+            align_corners,
+            scales[interp_dim - 2],
+            antialias);
+        indices_weights.emplace_back(std::move(weights.tensors));
+        interp_size = weights.interp_size;
       });
 
   TensorIteratorConfig config;
@@ -397,19 +563,9 @@ void _ti_separable_upsample_generic_Nd_kernel_impl_single_dim(
 
   auto iter = config.build();
 
-  if (interp_size > 1) {
-    // Nearest also supports uint8 tensor, so need to handle it separately
-    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "upsample_generic_Nd", [&] {
-      ti_cpu_upsample_generic_aa<scalar_t, index_t, out_ndims>(
-          iter, interp_size);
-    });
-  } else {
-    AT_DISPATCH_FLOATING_TYPES_AND(
-        at::ScalarType::Byte, iter.dtype(), "upsample_generic_Nd", [&] {
-          ti_cpu_upsample_generic_aa<scalar_t, index_t, out_ndims>(
-              iter, interp_size);
-        });
-  }
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "upsample_generic_Nd", [&] {
+    ti_cpu_upsample_generic_aa<scalar_t, index_t, out_ndims>(iter, interp_size);
+  });
 }
 
 template <
@@ -445,34 +601,113 @@ void ti_separable_upsample_generic_Nd_kernel_impl(
       F>(output, temp_input, 2, align_corners, scales, antialias);
 }
 
-void _ti_upsample_bilinear2d_kernel_impl(
+template <template <typename, typename> class F>
+void _ti_upsample_aa2d_kernel_impl(
     Tensor& output,
     const Tensor& input,
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w,
     bool antialias) {
-  ti_separable_upsample_generic_Nd_kernel_impl<
-      int64_t,
-      2,
-      scale_t,
-      HelperInterpLinear>(
+  ti_separable_upsample_generic_Nd_kernel_impl<int64_t, 2, scale_t, F>(
       output, input, align_corners, {scales_h, scales_w}, antialias);
 }
 
-void _ti_upsample_bicubic2d_kernel_impl(
-    Tensor& output,
-    const Tensor& input,
+// Backward of the separable antialiased interpolation: each output gradient
+// is scattered back onto the input window it was computed from, using the
+// same (cached) weight tables as the forward pass.
+template <
+    typename scalar_t,
+    typename index_t,
+    template <typename, typename>
+    class F>
+void cpu_upsample_genNd_backward_aa(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    bool align_corners,
+    const scale_t& scales) {
+  TORCH_CHECK(
+      grad_input.dtype() == grad_output.dtype(),
+      "expected dtype ",
+      grad_output.dtype(),
+      " for `grad_input` but got dtype ",
+      grad_input.dtype());
+
+  auto grad_output_ = grad_output.contiguous();
+  auto grad_input_ = grad_input.contiguous();
+
+  int64_t channels = grad_input_.size(0) * grad_input_.size(1);
+  int64_t input_height = grad_input_.size(2);
+  int64_t input_width = grad_input_.size(3);
+  int64_t output_height = grad_output_.size(2);
+  int64_t output_width = grad_output_.size(3);
+
+  // Tables are requested with a unit stride, so that ids_min holds plain
+  // element offsets into the input rows and columns
+  auto weights_h = get_indices_weights_aa<index_t, scalar_t, F>(
+      input_height, output_height, 1, 1, 0, align_corners, scales[0], true);
+  auto weights_w = get_indices_weights_aa<index_t, scalar_t, F>(
+      input_width, output_width, 1, 1, 0, align_corners, scales[1], true);
+
+  const index_t* ymin = weights_h.tensors[0].data_ptr<index_t>();
+  const index_t* ysize = weights_h.tensors[1].data_ptr<index_t>();
+  const scalar_t* wy = weights_h.tensors[3].data_ptr<scalar_t>();
+  const index_t* xmin = weights_w.tensors[0].data_ptr<index_t>();
+  const index_t* xsize = weights_w.tensors[1].data_ptr<index_t>();
+  const scalar_t* wx = weights_w.tensors[3].data_ptr<scalar_t>();
+  const int interp_height = weights_h.interp_size;
+  const int interp_width = weights_w.interp_size;
+
+  scalar_t* grad_input_data = grad_input_.data_ptr<scalar_t>();
+  const scalar_t* grad_output_data = grad_output_.data_ptr<scalar_t>();
+
+  auto loop = [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      scalar_t* gin = grad_input_data + c * input_height * input_width;
+      const scalar_t* gout =
+          grad_output_data + c * output_height * output_width;
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        const scalar_t* wy_ptr = wy + oh * interp_height;
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          const scalar_t* wx_ptr = wx + ow * interp_width;
+          const scalar_t g = gout[oh * output_width + ow];
+          for (index_t y = 0; y < ysize[oh]; y++) {
+            const scalar_t gy = g * wy_ptr[y];
+            scalar_t* gin_row = gin + (ymin[oh] + y) * input_width + xmin[ow];
+            for (index_t x = 0; x < xsize[ow]; x++) {
+              gin_row[x] += gy * wx_ptr[x];
+            }
+          }
+        }
+      }
+    }
+  };
+
+  // Channels are independent, hence they are processed in parallel
+  at::parallel_for(
+      0,
+      channels,
+      at::internal::GRAIN_SIZE /
+          std::max<int64_t>(output_height * output_width, 1) / 4,
+      loop);
+
+  if (!grad_input.is_contiguous()) {
+    grad_input.copy_(grad_input_);
+  }
+}
+
+template <template <typename, typename> class F>
+void _ti_upsample_aa2d_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
     bool align_corners,
     c10::optional<double> scales_h,
-    c10::optional<double> scales_w,
-    bool antialias) {
-  ti_separable_upsample_generic_Nd_kernel_impl<
-      int64_t,
-      2,
-      scale_t,
-      HelperInterpCubic>(
-      output, input, align_corners, {scales_h, scales_w}, antialias);
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(
+      grad_output.scalar_type(), "upsample_aa2d_backward", [&] {
+        cpu_upsample_genNd_backward_aa<scalar_t, int64_t, F>(
+            grad_input, grad_output, align_corners, {scales_h, scales_w});
+      });
 }
 
 } // namespace internal_upsample
@@ -484,7 +719,14 @@ namespace ops {
 
 namespace {
 
-at::Tensor interpolate_linear_aa_forward_kernel(
+using at::native::internal_upsample::HelperInterpBox;
+using at::native::internal_upsample::HelperInterpCubic;
+using at::native::internal_upsample::HelperInterpHamming;
+using at::native::internal_upsample::HelperInterpLanczos;
+using at::native::internal_upsample::HelperInterpLinear;
+
+template <template <typename, typename> class F>
+at::Tensor interpolate_aa_forward_kernel(
     const at::Tensor& input,
     at::IntArrayRef output_size,
     bool align_corners) {
@@ -510,62 +752,418 @@ at::Tensor interpolate_linear_aa_forward_kernel(
       input.sizes());
 
   output.resize_(full_output_size, input.suggest_memory_format());
-  at::native::internal_upsample::_ti_upsample_bilinear2d_kernel_impl(
+  at::native::internal_upsample::_ti_upsample_aa2d_kernel_impl<F>(
       output, input, align_corners, scale_h, scale_w, /*antialias=*/true);
   return output;
 }
 
-at::Tensor interpolate_bicubic_aa_forward_kernel(
-    const at::Tensor& input,
+template <template <typename, typename> class F>
+at::Tensor interpolate_aa_backward_kernel(
+    const at::Tensor& grad_output,
     at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
     bool align_corners) {
-  TORCH_CHECK(input.device().is_cpu(), "input must be a CPU tensor");
+  TORCH_CHECK(
+      grad_output.device().is_cpu(), "grad_output must be a CPU tensor");
 
   c10::optional<c10::ArrayRef<double>> scale_factors = {};
 
   // Copied from UpSampleBilinear2d.cpp
-  auto output = at::empty({0}, input.options());
+  auto grad_input = at::empty({0}, grad_output.options());
   auto osize = at::native::upsample::compute_output_size(
-      input.sizes(), output_size, scale_factors);
+      input_size, output_size, scale_factors);
   auto scale_h = at::native::upsample::get_scale_value(scale_factors, 0);
   auto scale_w = at::native::upsample::get_scale_value(scale_factors, 1);
   auto full_output_size =
-      at::native::upsample_2d_common_check(input.sizes(), osize);
+      at::native::upsample_2d_common_check(input_size, osize);
 
-  // Allow for empty batch size but not other dimensions
   TORCH_CHECK(
-      input.numel() != 0 ||
-          c10::multiply_integers(
-              input.sizes().begin() + 1, input.sizes().end()),
-      "Non-empty 4D data tensor expected but got a tensor with sizes ",
+      grad_output.dim() == 4,
+      "Expected grad_output to be a tensor of dimension 4 but got: dimension ",
+      grad_output.dim());
+
+  for (int i = 0; i < 4; ++i) {
+    TORCH_CHECK(
+        grad_output.size(i) == full_output_size[i],
+        "Expected grad_output to have the same shape as output;",
+        " output.size(",
+        i,
+        ") = ",
+        full_output_size[i],
+        " but got grad_output.size(",
+        i,
+        ") = ",
+        grad_output.size(i));
+  }
+
+  grad_input.resize_(input_size, grad_output.suggest_memory_format());
+  grad_input.zero_();
+  at::native::internal_upsample::_ti_upsample_aa2d_backward_kernel_impl<F>(
+      grad_input, grad_output, align_corners, scale_h, scale_w);
+  return grad_input;
+}
+
+std::tuple<at::Tensor, at::Tensor> resize_pad_batch_kernel(
+    at::TensorList images,
+    at::IntArrayRef sizes,
+    c10::string_view interpolation,
+    bool antialias,
+    int64_t size_divisible,
+    bool channels_last) {
+  const std::string mode(interpolation.data(), interpolation.size());
+  const int64_t batch_size = images.size();
+
+  TORCH_CHECK(batch_size > 0, "Expected a non empty list of images");
+  TORCH_CHECK(
+      static_cast<int64_t>(sizes.size()) == 2 * batch_size,
+      "Expected one (height, width) pair per image in sizes, got ",
+      sizes.size(),
+      " values for ",
+      batch_size,
+      " images");
+  TORCH_CHECK(size_divisible > 0, "size_divisible should be positive");
+  if (antialias) {
+    TORCH_CHECK(
+        mode == "bilinear" || mode == "bicubic" || mode == "box" ||
+            mode == "hamming" || mode == "lanczos",
+        "Antialias is not supported for interpolation mode ",
+        mode);
+  } else {
+    TORCH_CHECK(
+        mode == "nearest" || mode == "bilinear" || mode == "bicubic",
+        "Interpolation mode ",
+        mode,
+        " is only supported with antialias");
+  }
+
+  const auto& first = images[0];
+  int64_t max_height = 0, max_width = 0;
+  for (int64_t i = 0; i < batch_size; i++) {
+    const auto& image = images[i];
+    TORCH_CHECK(image.device().is_cpu(), "images must be CPU tensors");
+    TORCH_CHECK(
+        image.dim() == 3,
+        "images are expected to be 3d tensors of shape [C, H, W], got ",
+        image.sizes());
+    TORCH_CHECK(
+        image.size(0) == first.size(0) &&
+            image.scalar_type() == first.scalar_type(),
+        "images should all have the same number of channels and dtype");
+    TORCH_CHECK(
+        image.is_floating_point(), "images should be floating point tensors");
+    TORCH_CHECK(
+        sizes[2 * i] > 0 && sizes[2 * i + 1] > 0,
+        "Output sizes should be greater than 0, got (",
+        sizes[2 * i],
+        ", ",
+        sizes[2 * i + 1],
+        ")");
+    max_height = std::max(max_height, sizes[2 * i]);
+    max_width = std::max(max_width, sizes[2 * i + 1]);
+  }
+  max_height = (max_height + size_divisible - 1) / size_divisible *
+      size_divisible;
+  max_width =
+      (max_width + size_divisible - 1) / size_divisible * size_divisible;
+
+  auto memory_format = channels_last ? at::MemoryFormat::ChannelsLast
+                                     : at::MemoryFormat::Contiguous;
+  auto batch = at::zeros(
+      {batch_size, first.size(0), max_height, max_width},
+      first.options().memory_format(memory_format));
+  auto image_sizes = at::tensor(sizes, at::kLong).view({batch_size, 2});
+
+  using at::native::internal_upsample::_ti_upsample_aa2d_kernel_impl;
+
+  auto loop = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      auto input = images[i].unsqueeze(0);
+      int64_t height = sizes[2 * i], width = sizes[2 * i + 1];
+      // The resized image is written in place in the top-left corner of its
+      // slot of the batch, the rest of the slot being the zero padding
+      auto output = batch.narrow(0, i, 1)
+                        .narrow(2, 0, height)
+                        .narrow(3, 0, width);
+      if (mode == "bilinear") {
+        // Without antialias the linear filter is plain bilinear interpolation
+        _ti_upsample_aa2d_kernel_impl<HelperInterpLinear>(
+            output, input, false, c10::nullopt, c10::nullopt, antialias);
+      } else if (antialias && mode == "bicubic") {
+        _ti_upsample_aa2d_kernel_impl<HelperInterpCubic>(
+            output, input, false, c10::nullopt, c10::nullopt, true);
+      } else if (mode == "box") {
+        _ti_upsample_aa2d_kernel_impl<HelperInterpBox>(
+            output, input, false, c10::nullopt, c10::nullopt, true);
+      } else if (mode == "hamming") {
+        _ti_upsample_aa2d_kernel_impl<HelperInterpHamming>(
+            output, input, false, c10::nullopt, c10::nullopt, true);
+      } else if (mode == "lanczos") {
+        _ti_upsample_aa2d_kernel_impl<HelperInterpLanczos>(
+            output, input, false, c10::nullopt, c10::nullopt, true);
+      } else if (mode == "bicubic") {
+        // PyTorch's bicubic does not use the same filter as PIL, so we fall
+        // back to it and copy the result into the batch
+        output.copy_(at::upsample_bicubic2d(input, {height, width}, false));
+      } else {
+        output.copy_(at::upsample_nearest2d(input, {height, width}));
+      }
+    }
+  };
+
+  // Images are resized in parallel, one image per task
+  at::parallel_for(0, batch_size, 1, loop);
+
+  return std::make_tuple(batch, image_sizes);
+}
+
+// Fused crop + resize + normalization of a uint8 image. The crop is a view of
+// the input, its rows are filtered horizontally into a float buffer holding
+// only output_width columns, and the vertical pass normalizes and casts each
+// output value before writing it with the strides of the output tensor.
+template <template <typename, typename> class F, typename out_t>
+void resized_crop_normalize_impl(
+    at::Tensor& output,
+    const at::Tensor& crop,
+    const std::vector<float>& scale,
+    const std::vector<float>& shift,
+    bool antialias) {
+  using at::native::internal_upsample::get_indices_weights_aa;
+
+  const int64_t channels = crop.size(0);
+  const int64_t input_height = crop.size(1);
+  const int64_t input_width = crop.size(2);
+  const int64_t output_height = output.size(1);
+  const int64_t output_width = output.size(2);
+
+  // Unit stride tables: ids_min holds plain row and column indices
+  auto weights_h = get_indices_weights_aa<int64_t, float, F>(
+      input_height, output_height, 1, 1, 0, false, c10::nullopt, antialias);
+  auto weights_w = get_indices_weights_aa<int64_t, float, F>(
+      input_width, output_width, 1, 1, 0, false, c10::nullopt, antialias);
+
+  const int64_t* ymin = weights_h.tensors[0].data_ptr<int64_t>();
+  const int64_t* ysize = weights_h.tensors[1].data_ptr<int64_t>();
+  const float* wy = weights_h.tensors[3].data_ptr<float>();
+  const int64_t* xmin = weights_w.tensors[0].data_ptr<int64_t>();
+  const int64_t* xsize = weights_w.tensors[1].data_ptr<int64_t>();
+  const float* wx = weights_w.tensors[3].data_ptr<float>();
+  const int interp_height = weights_h.interp_size;
+  const int interp_width = weights_w.interp_size;
+
+  // The crop may be a CHW or an HWC image (or any other view), it is read
+  // with its own strides
+  const uint8_t* src = crop.data_ptr<uint8_t>();
+  const int64_t src_stride_c = crop.stride(0);
+  const int64_t src_stride_h = crop.stride(1);
+  const int64_t src_stride_w = crop.stride(2);
+
+  // Horizontally resized rows, stored channels last
+  auto buffer =
+      at::empty({input_height, output_width, channels}, at::kFloat);
+  float* buffer_data = buffer.data_ptr<float>();
+
+  at::parallel_for(
+      0,
+      input_height,
+      at::internal::GRAIN_SIZE /
+          std::max<int64_t>(output_width * channels * interp_width, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t y = begin; y < end; y++) {
+          const uint8_t* src_row = src + y * src_stride_h;
+          float* buffer_row = buffer_data + y * output_width * channels;
+          for (int64_t ox = 0; ox < output_width; ox++) {
+            const float* wx_ptr = wx + ox * interp_width;
+            const uint8_t* src_px = src_row + xmin[ox] * src_stride_w;
+            for (int64_t c = 0; c < channels; c++) {
+              const uint8_t* src_ptr = src_px + c * src_stride_c;
+              float acc = 0.f;
+              for (int64_t x = 0; x < xsize[ox]; x++) {
+                acc += wx_ptr[x] * src_ptr[x * src_stride_w];
+              }
+              buffer_row[ox * channels + c] = acc;
+            }
+          }
+        }
+      });
+
+  out_t* dst = output.data_ptr<out_t>();
+  const int64_t dst_stride_c = output.stride(0);
+  const int64_t dst_stride_h = output.stride(1);
+  const int64_t dst_stride_w = output.stride(2);
+
+  at::parallel_for(
+      0,
+      output_height,
+      at::internal::GRAIN_SIZE /
+          std::max<int64_t>(output_width * channels * interp_height, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t oy = begin; oy < end; oy++) {
+          const float* wy_ptr = wy + oy * interp_height;
+          const float* buffer_rows =
+              buffer_data + ymin[oy] * output_width * channels;
+          out_t* dst_row = dst + oy * dst_stride_h;
+          for (int64_t ox = 0; ox < output_width; ox++) {
+            for (int64_t c = 0; c < channels; c++) {
+              const float* buffer_ptr = buffer_rows + ox * channels + c;
+              float acc = 0.f;
+              for (int64_t y = 0; y < ysize[oy]; y++) {
+                acc += wy_ptr[y] * buffer_ptr[y * output_width * channels];
+              }
+              // Filters with negative lobes may overshoot the uint8 range
+              acc = std::min(std::max(acc, 0.f), 255.f);
+              dst_row[c * dst_stride_c + ox * dst_stride_w] =
+                  static_cast<out_t>(acc * scale[c] + shift[c]);
+            }
+          }
+        }
+      });
+}
+
+at::Tensor resized_crop_normalize_kernel(
+    const at::Tensor& input,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    at::IntArrayRef output_size,
+    at::ArrayRef<double> mean,
+    at::ArrayRef<double> stddev,
+    c10::string_view interpolation,
+    bool antialias,
+    at::ScalarType dtype,
+    bool channels_last) {
+  const std::string mode(interpolation.data(), interpolation.size());
+
+  TORCH_CHECK(input.device().is_cpu(), "input must be a CPU tensor");
+  TORCH_CHECK(
+      input.dim() == 3,
+      "input is expected to be a 3d tensor of shape [C, H, W], got ",
       input.sizes());
+  TORCH_CHECK(
+      input.scalar_type() == at::kByte,
+      "input should be a uint8 tensor, got ",
+      input.scalar_type());
+  TORCH_CHECK(
+      dtype == at::kFloat || dtype == at::kBFloat16,
+      "dtype should be float or bfloat16, got ",
+      dtype);
+  TORCH_CHECK(
+      top >= 0 && left >= 0 && height > 0 && width > 0 &&
+          top + height <= input.size(1) && left + width <= input.size(2),
+      "Crop box (top=",
+      top,
+      ", left=",
+      left,
+      ", height=",
+      height,
+      ", width=",
+      width,
+      ") is not contained in the input of size ",
+      input.sizes());
+  TORCH_CHECK(
+      output_size.size() == 2 && output_size[0] > 0 && output_size[1] > 0,
+      "output_size should hold a positive (height, width) pair, got ",
+      output_size);
 
-  output.resize_(full_output_size, input.suggest_memory_format());
-  at::native::internal_upsample::_ti_upsample_bicubic2d_kernel_impl(
-      output, input, align_corners, scale_h, scale_w, /*antialias=*/true);
+  const int64_t channels = input.size(0);
+  TORCH_CHECK(
+      static_cast<int64_t>(mean.size()) == channels &&
+          static_cast<int64_t>(stddev.size()) == channels,
+      "mean and std should have one value per channel");
+  if (antialias) {
+    TORCH_CHECK(
+        mode == "bilinear" || mode == "bicubic" || mode == "box" ||
+            mode == "hamming" || mode == "lanczos",
+        "Antialias is not supported for interpolation mode ",
+        mode);
+  } else {
+    TORCH_CHECK(
+        mode == "bilinear",
+        "Interpolation mode ",
+        mode,
+        " is only supported with antialias");
+  }
+
+  // Values are rescaled to [0, 1] before being normalized, as done by
+  // ToTensor, hence (x / 255 - mean) / std is folded into x * scale + shift
+  std::vector<float> scale(channels), shift(channels);
+  for (int64_t c = 0; c < channels; c++) {
+    TORCH_CHECK(
+        stddev[c] != 0,
+        "std evaluated to zero, leading to division by zero.");
+    scale[c] = static_cast<float>(1.0 / (255.0 * stddev[c]));
+    shift[c] = static_cast<float>(-mean[c] / stddev[c]);
+  }
+
+  // A channels last output is returned as a CHW view of an HWC tensor
+  auto options = input.options().dtype(dtype);
+  auto output = channels_last
+      ? at::empty({output_size[0], output_size[1], channels}, options)
+            .permute({2, 0, 1})
+      : at::empty({channels, output_size[0], output_size[1]}, options);
+  auto crop = input.narrow(1, top, height).narrow(2, left, width);
+
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::kBFloat16, dtype, "resized_crop_normalize", [&] {
+        if (mode == "bilinear") {
+          resized_crop_normalize_impl<HelperInterpLinear, scalar_t>(
+              output, crop, scale, shift, antialias);
+        } else if (mode == "bicubic") {
+          resized_crop_normalize_impl<HelperInterpCubic, scalar_t>(
+              output, crop, scale, shift, true);
+        } else if (mode == "box") {
+          resized_crop_normalize_impl<HelperInterpBox, scalar_t>(
+              output, crop, scale, shift, true);
+        } else if (mode == "hamming") {
+          resized_crop_normalize_impl<HelperInterpHamming, scalar_t>(
+              output, crop, scale, shift, true);
+        } else {
+          resized_crop_normalize_impl<HelperInterpLanczos, scalar_t>(
+              output, crop, scale, shift, true);
+        }
+      });
   return output;
 }
 
-// TODO: Implement backward function
-// at::Tensor interpolate_linear_aa_backward_kernel(
-//     const at::Tensor& grad) {
-//   return grad_input;
-// }
-
 } // namespace
 
 TORCH_LIBRARY_IMPL(torchvision, CPU, m) {
   m.impl(
       TORCH_SELECTIVE_NAME("torchvision::_interpolate_linear_aa"),
-      TORCH_FN(interpolate_linear_aa_forward_kernel));
+      TORCH_FN(interpolate_aa_forward_kernel<HelperInterpLinear>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_linear_aa_backward"),
+      TORCH_FN(interpolate_aa_backward_kernel<HelperInterpLinear>));
   m.impl(
       TORCH_SELECTIVE_NAME("torchvision::_interpolate_bicubic_aa"),
-      TORCH_FN(interpolate_bicubic_aa_forward_kernel));
-
-  // TODO: Implement backward function
-  //   m.impl(
-  //       TORCH_SELECTIVE_NAME("torchvision::_interpolate_linear_aa_backward"),
-  //       TORCH_FN(interpolate_linear_aa_backward_kernel));
+      TORCH_FN(interpolate_aa_forward_kernel<HelperInterpCubic>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_bicubic_aa_backward"),
+      TORCH_FN(interpolate_aa_backward_kernel<HelperInterpCubic>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_box_aa"),
+      TORCH_FN(interpolate_aa_forward_kernel<HelperInterpBox>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_box_aa_backward"),
+      TORCH_FN(interpolate_aa_backward_kernel<HelperInterpBox>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_hamming_aa"),
+      TORCH_FN(interpolate_aa_forward_kernel<HelperInterpHamming>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_hamming_aa_backward"),
+      TORCH_FN(interpolate_aa_backward_kernel<HelperInterpHamming>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_lanczos_aa"),
+      TORCH_FN(interpolate_aa_forward_kernel<HelperInterpLanczos>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_interpolate_lanczos_aa_backward"),
+      TORCH_FN(interpolate_aa_backward_kernel<HelperInterpLanczos>));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_resize_pad_batch"),
+      TORCH_FN(resize_pad_batch_kernel));
+  m.impl(
+      TORCH_SELECTIVE_NAME("torchvision::_resized_crop_normalize"),
+      TORCH_FN(resized_crop_normalize_kernel));
 }
 
 } // namespace ops
@@ -5,7 +5,7 @@
 namespace vision {
 namespace ops {
 
-at::Tensor interpolate_linear_aa(
+at::Tensor _interpolate_linear_aa(
     const at::Tensor& input, // Input image
     at::IntArrayRef output_size, // Output image size
     bool align_corners) // The flag to align corners
@@ -13,11 +13,11 @@ at::Tensor interpolate_linear_aa(
   static auto op =
       c10::Dispatcher::singleton()
           .findSchemaOrThrow("torchvision::_interpolate_linear_aa", "")
-          .typed<decltype(interpolate_linear_aa)>();
+          .typed<decltype(_interpolate_linear_aa)>();
   return op.call(input, output_size, align_corners);
 }
 
-at::Tensor interpolate_bicubic_aa(
+at::Tensor _interpolate_bicubic_aa(
     const at::Tensor& input, // Input image
     at::IntArrayRef output_size, // Output image size
     bool align_corners) // The flag to align corners
@@ -29,30 +29,187 @@ at::Tensor interpolate_bicubic_aa(
   return op.call(input, output_size, align_corners);
 }
 
+at::Tensor _interpolate_box_aa(
+    const at::Tensor& input, // Input image
+    at::IntArrayRef output_size, // Output image size
+    bool align_corners) // The flag to align corners
+{
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow("torchvision::_interpolate_box_aa", "")
+          .typed<decltype(_interpolate_box_aa)>();
+  return op.call(input, output_size, align_corners);
+}
+
+at::Tensor _interpolate_hamming_aa(
+    const at::Tensor& input, // Input image
+    at::IntArrayRef output_size, // Output image size
+    bool align_corners) // The flag to align corners
+{
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow("torchvision::_interpolate_hamming_aa", "")
+          .typed<decltype(_interpolate_hamming_aa)>();
+  return op.call(input, output_size, align_corners);
+}
+
+at::Tensor _interpolate_lanczos_aa(
+    const at::Tensor& input, // Input image
+    at::IntArrayRef output_size, // Output image size
+    bool align_corners) // The flag to align corners
+{
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow("torchvision::_interpolate_lanczos_aa", "")
+          .typed<decltype(_interpolate_lanczos_aa)>();
+  return op.call(input, output_size, align_corners);
+}
+
+std::tuple<at::Tensor, at::Tensor> _resize_pad_batch(
+    at::TensorList images,
+    at::IntArrayRef sizes,
+    c10::string_view interpolation,
+    bool antialias,
+    int64_t size_divisible,
+    bool channels_last) {
+  static auto op = c10::Dispatcher::singleton()
+                       .findSchemaOrThrow("torchvision::_resize_pad_batch", "")
+                       .typed<decltype(_resize_pad_batch)>();
+  return op.call(
+      images,
+      sizes,
+      interpolation,
+      antialias,
+      size_divisible,
+      channels_last);
+}
+
+at::Tensor _resized_crop_normalize(
+    const at::Tensor& input,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    at::IntArrayRef output_size,
+    at::ArrayRef<double> mean,
+    at::ArrayRef<double> stddev,
+    c10::string_view interpolation,
+    bool antialias,
+    at::ScalarType dtype,
+    bool channels_last) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow("torchvision::_resized_crop_normalize", "")
+          .typed<decltype(_resized_crop_normalize)>();
+  return op.call(
+      input,
+      top,
+      left,
+      height,
+      width,
+      output_size,
+      mean,
+      stddev,
+      interpolation,
+      antialias,
+      dtype,
+      channels_last);
+}
+
 namespace detail {
 
-// TODO: Implement backward function
-// at::Tensor _interpolate_linear_aa_backward(
-//     const at::Tensor& grad,
-//     at::IntArrayRef output_size,
-//     bool align_corners)
-// {
-//   return at::Tensor();
-// }
+at::Tensor _interpolate_linear_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow(
+              "torchvision::_interpolate_linear_aa_backward", "")
+          .typed<decltype(_interpolate_linear_aa_backward)>();
+  return op.call(grad_output, output_size, input_size, align_corners);
+}
+
+at::Tensor _interpolate_bicubic_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow(
+              "torchvision::_interpolate_bicubic_aa_backward", "")
+          .typed<decltype(_interpolate_bicubic_aa_backward)>();
+  return op.call(grad_output, output_size, input_size, align_corners);
+}
+
+at::Tensor _interpolate_box_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow(
+              "torchvision::_interpolate_box_aa_backward", "")
+          .typed<decltype(_interpolate_box_aa_backward)>();
+  return op.call(grad_output, output_size, input_size, align_corners);
+}
+
+at::Tensor _interpolate_hamming_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow(
+              "torchvision::_interpolate_hamming_aa_backward", "")
+          .typed<decltype(_interpolate_hamming_aa_backward)>();
+  return op.call(grad_output, output_size, input_size, align_corners);
+}
+
+at::Tensor _interpolate_lanczos_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners) {
+  static auto op =
+      c10::Dispatcher::singleton()
+          .findSchemaOrThrow(
+              "torchvision::_interpolate_lanczos_aa_backward", "")
+          .typed<decltype(_interpolate_lanczos_aa_backward)>();
+  return op.call(grad_output, output_size, input_size, align_corners);
+}
 
 } // namespace detail
 
 TORCH_LIBRARY_FRAGMENT(torchvision, m) {
   m.def(TORCH_SELECTIVE_SCHEMA(
       "torchvision::_interpolate_linear_aa(Tensor input, int[] output_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_linear_aa_backward(Tensor grad_output, int[] output_size, int[] input_size, bool align_corners) -> Tensor"));
   m.def(TORCH_SELECTIVE_SCHEMA(
       "torchvision::_interpolate_bicubic_aa(Tensor input, int[] output_size, bool align_corners) -> Tensor"));
-  // TODO: Implement backward function
-  // m.def(TORCH_SELECTIVE_SCHEMA(
-  //     "torchvision::_interpolate_linear_aa_backward(Tensor grad, Tensor rois,
-  //     float spatial_scale, int pooled_height, int pooled_width, int
-  //     batch_size, int channels, int height, int width, int sampling_ratio,
-  //     bool aligned) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_bicubic_aa_backward(Tensor grad_output, int[] output_size, int[] input_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_box_aa(Tensor input, int[] output_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_box_aa_backward(Tensor grad_output, int[] output_size, int[] input_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_hamming_aa(Tensor input, int[] output_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_hamming_aa_backward(Tensor grad_output, int[] output_size, int[] input_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_lanczos_aa(Tensor input, int[] output_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_interpolate_lanczos_aa_backward(Tensor grad_output, int[] output_size, int[] input_size, bool align_corners) -> Tensor"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_resize_pad_batch(Tensor[] images, int[] sizes, str interpolation, bool antialias, int size_divisible, bool channels_last) -> (Tensor, Tensor)"));
+  m.def(TORCH_SELECTIVE_SCHEMA(
+      "torchvision::_resized_crop_normalize(Tensor input, int top, int left, int height, int width, int[] output_size, float[] mean, float[] std, str interpolation, bool antialias, ScalarType dtype, bool channels_last) -> Tensor"));
 }
 
 } // namespace ops
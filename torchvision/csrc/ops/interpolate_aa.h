@@ -16,13 +16,83 @@ VISION_API at::Tensor _interpolate_bicubic_aa(
     at::IntArrayRef output_size,
     bool align_corners = false);
 
+VISION_API at::Tensor _interpolate_box_aa(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners = false);
+
+VISION_API at::Tensor _interpolate_hamming_aa(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners = false);
+
+VISION_API at::Tensor _interpolate_lanczos_aa(
+    const at::Tensor& input,
+    at::IntArrayRef output_size,
+    bool align_corners = false);
+
+// Resizes each image of the list to its own size and writes the results into
+// a zero-padded batch whose spatial dimensions are a multiple of
+// size_divisible. sizes holds one (height, width) pair per image. Returns the
+// batch and the sizes of the resized images.
+VISION_API std::tuple<at::Tensor, at::Tensor> _resize_pad_batch(
+    at::TensorList images,
+    at::IntArrayRef sizes,
+    c10::string_view interpolation,
+    bool antialias,
+    int64_t size_divisible = 32,
+    bool channels_last = false);
+
+// Crops a uint8 [C, H, W] image (which may be a permuted view of an HWC
+// image), resizes the crop to output_size and normalizes it with mean and std
+// after rescaling it to [0, 1], in a single pass over the cropped pixels.
+// The output has the given floating point dtype; when channels_last is set it
+// is a [C, H, W] view of an HWC tensor.
+VISION_API at::Tensor _resized_crop_normalize(
+    const at::Tensor& input,
+    int64_t top,
+    int64_t left,
+    int64_t height,
+    int64_t width,
+    at::IntArrayRef output_size,
+    at::ArrayRef<double> mean,
+    at::ArrayRef<double> stddev,
+    c10::string_view interpolation = "bilinear",
+    bool antialias = true,
+    at::ScalarType dtype = at::kFloat,
+    bool channels_last = false);
+
 namespace detail {
 
-// TODO: Implement backward function
-// at::Tensor _interpolate_linear_aa_backward(
-//     const at::Tensor& grad,
-//     at::IntArrayRef output_size,
-//     bool align_corners=false);
+at::Tensor _interpolate_linear_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners);
+
+at::Tensor _interpolate_bicubic_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners);
+
+at::Tensor _interpolate_box_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners);
+
+at::Tensor _interpolate_hamming_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners);
+
+at::Tensor _interpolate_lanczos_aa_backward(
+    const at::Tensor& grad_output,
+    at::IntArrayRef output_size,
+    at::IntArrayRef input_size,
+    bool align_corners);
 
 } // namespace detail
 
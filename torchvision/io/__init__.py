@@ -4,6 +4,7 @@ from ._video_opt import (
     Timebase,
     VideoMetaData,
     _HAS_VIDEO_OPT,
+    _build_packet_index_from_file,
     _probe_video_from_file,
     _probe_video_from_memory,
     _read_video_from_file,
@@ -17,14 +18,29 @@ from .video import (
     write_video,
 )
 from .image import (
+    ImageInfo,
     ImageReadMode,
+    crop_jpeg,
     decode_image,
+    decode_image_batch,
+    decode_image_out,
     decode_jpeg,
+    decode_jpeg_batch,
+    decode_jpeg_crop,
+    decode_jpeg_out,
+    decode_jpeg_raw,
     decode_png,
+    decode_png_out,
     encode_jpeg,
+    encode_jpeg_batch,
     encode_png,
+    get_decoded_shape,
+    probe_image,
+    probe_image_batch,
     read_file,
     read_image,
+    read_image_batch,
+    transform_jpeg,
     write_file,
     write_jpeg,
     write_png,
@@ -97,9 +113,19 @@ class VideoReader:
         stream (string, optional): descriptor of the required stream, followed by the stream id,
             in the format ``{stream_type}:{stream_id}``. Defaults to ``"video:0"``.
             Currently available options include ``['video', 'audio']``
+
+        num_threads (int, optional): number of codec decoding threads, 0 uses one thread per core.
+            Defaults to ``1``.
+
+        thread_type (string, optional): codec threading mode, one of ``"auto"``, ``"frame"`` or
+            ``"slice"``. Defaults to ``"auto"``, which uses whatever the codec supports.
+
+        packet_index (Tensor, optional): index of the packets of the file, as returned by
+            ``_build_packet_index_from_file``. Seeks then start decoding at the key frame preceding
+            the seek time. An index of another file is ignored. Defaults to ``None``.
     """
 
-    def __init__(self, path, stream="video"):
+    def __init__(self, path, stream="video", num_threads=1, thread_type="auto", packet_index=None):
         if not _has_video_opt():
             raise RuntimeError(
                 "Not compiled with video_reader support, "
@@ -107,7 +133,7 @@ class VideoReader:
                 + "ffmpeg (version 4.2 is currently supported) and"
                 + "build torchvision from source."
             )
-        self._c = torch.classes.torchvision.Video(path, stream)
+        self._c = torch.classes.torchvision.Video(path, stream, num_threads, thread_type, packet_index)
 
     def __next__(self):
         """Decodes and returns the next frame of the current stream.
@@ -179,6 +205,7 @@ __all__ = [
     "_read_video_from_file",
     "_read_video_timestamps_from_file",
     "_probe_video_from_file",
+    "_build_packet_index_from_file",
     "_read_video_from_memory",
     "_read_video_timestamps_from_memory",
     "_probe_video_from_memory",
@@ -187,14 +214,29 @@ __all__ = [
     "_read_video_meta_data",
     "VideoMetaData",
     "Timebase",
+    "ImageInfo",
     "ImageReadMode",
+    "crop_jpeg",
     "decode_image",
+    "decode_image_batch",
+    "decode_image_out",
     "decode_jpeg",
+    "decode_jpeg_batch",
+    "decode_jpeg_crop",
+    "decode_jpeg_out",
+    "decode_jpeg_raw",
     "decode_png",
+    "decode_png_out",
     "encode_jpeg",
+    "encode_jpeg_batch",
     "encode_png",
+    "get_decoded_shape",
+    "probe_image",
+    "probe_image_batch",
     "read_file",
     "read_image",
+    "read_image_batch",
+    "transform_jpeg",
     "write_file",
     "write_jpeg",
     "write_png",
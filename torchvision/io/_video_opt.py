@@ -4,7 +4,7 @@ import math
 import os
 import warnings
 from fractions import Fraction
-from typing import List, Tuple
+from typing import List, Optional, Tuple
 
 import numpy as np
 import torch
@@ -175,6 +175,9 @@ def _read_video_from_file(
     audio_channels=0,
     audio_pts_range=(0, -1),
     audio_timebase=default_timebase,
+    num_threads=1,
+    thread_type="auto",
+    packet_index=None,
 ):
     """
     Reads a video from a file, returning both the video frames as well as
@@ -217,6 +220,14 @@ def _read_video_from_file(
     audio_channels (int optional): audio channels
     audio_pts_range (list(int), optional): the start and end presentation timestamp of audio stream
     audio_timebase (Fraction, optional): a Fraction rational number which denotes time base in audio stream
+    num_threads (int, optional): number of codec decoding threads, 0 uses one thread per core. Default: 1
+    thread_type (str, optional): codec threading mode, one of ``"auto"``, ``"frame"`` or ``"slice"``.
+        Frame threading decodes several frames at once, slice threading splits a frame between the
+        threads. ``"auto"`` uses whatever the codec supports. Default: ``"auto"``
+    packet_index (Tensor, optional): index of the packets of the file, as returned by
+        ``_build_packet_index_from_file``. The decoder then seeks straight to the key frame
+        preceding the start of ``video_pts_range``, instead of ``seek_frame_margin`` earlier.
+        An index of another file is ignored
 
     Returns
         vframes (Tensor[T, H, W, C]): the `T` video frames
@@ -248,6 +259,9 @@ def _read_video_from_file(
         audio_pts_range[1],
         audio_timebase.numerator,
         audio_timebase.denominator,
+        num_threads,
+        thread_type,
+        packet_index,
     )
     vframes, _vframe_pts, vtimebase, vfps, vduration, \
         aframes, aframe_pts, atimebase, asample_rate, aduration = (
@@ -296,6 +310,15 @@ def _read_video_timestamps_from_file(filename):
     return vframe_pts, aframe_pts, info
 
 
+def _build_packet_index_from_file(filename):
+    """
+    Reads all packets of a video file, without decoding them, and returns their index
+    (pts, key frame flags and byte offsets) serialized in a uint8 tensor. It can be stored
+    and passed to the later ``_read_video_from_file`` calls of the same file
+    """
+    return torch.ops.video_reader.build_packet_index_from_file(filename)
+
+
 def _probe_video_from_file(filename):
     """
     Probe a video file and return VideoMetaData with info about the video
@@ -323,6 +346,9 @@ def _read_video_from_memory(
     audio_pts_range=(0, -1),  # type: List[int]
     audio_timebase_numerator=0,  # type: int
     audio_timebase_denominator=1,  # type: int
+    num_threads=1,  # type: int
+    thread_type="auto",  # type: str
+    packet_index=None,  # type: Optional[torch.Tensor]
 ):
     # type: (...) -> Tuple[torch.Tensor, torch.Tensor]
     """
@@ -370,6 +396,11 @@ def _read_video_from_memory(
     audio_pts_range (list(int), optional): the start and end presentation timestamp of audio stream
     audio_timebase_numerator / audio_timebase_denominator (float, optional):
         a rational number which denotes time base in audio stream
+    num_threads (int, optional): number of codec decoding threads, 0 uses one thread per core. Default: 1
+    thread_type (str, optional): codec threading mode, one of ``"auto"``, ``"frame"`` or ``"slice"``.
+        Default: ``"auto"``
+    packet_index (Tensor, optional): index of the packets of the video, as returned by
+        ``_build_packet_index_from_file`` for the file of ``video_data``, see ``_read_video_from_file``
 
     Returns:
         vframes (Tensor[T, H, W, C]): the `T` video frames
@@ -403,6 +434,9 @@ def _read_video_from_memory(
         audio_pts_range[1],
         audio_timebase_numerator,
         audio_timebase_denominator,
+        num_threads,
+        thread_type,
+        packet_index,
     )
 
     vframes, _vframe_pts, vtimebase, vfps, vduration, \
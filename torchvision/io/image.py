@@ -5,6 +5,7 @@ import os.path as osp
 import importlib.machinery
 
 from enum import Enum
+from typing import List, NamedTuple, Optional, Tuple
 
 _HAS_IMAGE_OPT = False
 
@@ -65,18 +66,23 @@ class ImageReadMode(Enum):
     RGB_ALPHA = 4
 
 
-def read_file(path: str) -> torch.Tensor:
+def read_file(path: str, mmap: bool = False) -> torch.Tensor:
     """
     Reads and outputs the bytes contents of a file as a uint8 Tensor
     with one dimension.
 
     Args:
         path (str): the path to the file to be read
+        mmap (bool): if True, the returned tensor is a private copy-on-write
+            memory mapping of the file, rather than a copy of its contents read into
+            memory. Writing to the tensor does not modify the file. If the file is
+            truncated while it is mapped, reading the missing pages kills the process
+            with SIGBUS, whereas the copy raises an error. Default: False
 
     Returns:
         data (Tensor)
     """
-    data = torch.ops.image.read_file(path)
+    data = torch.ops.image.read_file(path, mmap)
     return data
 
 
@@ -92,11 +98,14 @@ def write_file(filename: str, data: torch.Tensor) -> None:
     torch.ops.image.write_file(filename, data)
 
 
-def decode_png(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torch.Tensor:
+def decode_png(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED,
+               channels_last: bool = True, allow_16_bits: bool = False,
+               skip_checksums: bool = False) -> torch.Tensor:
     """
     Decodes a PNG image into a 3 dimensional RGB Tensor.
     Optionally converts the image to the desired format.
-    The values of the output tensor are uint8 between 0 and 255.
+    The values of the output tensor are uint8 between 0 and 255, unless
+    ``allow_16_bits`` is set.
 
     Args:
         input (Tensor[1]): a one dimensional uint8 tensor containing
@@ -105,15 +114,26 @@ def decode_png(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGE
             converting the image. Default: ``ImageReadMode.UNCHANGED``.
             See `ImageReadMode` class for more information on various
             available modes.
+        channels_last (bool): if True, the output is a view of an image stored in
+            ``[image_height, image_width, image_channels]`` (channels last) order, as
+            produced by the decoder. If False, the decoder writes a contiguous
+            tensor directly, which avoids a later ``.contiguous()`` copy. Default: True
+        allow_16_bits (bool): if True, 16 bits images are decoded at full precision into an int32
+            tensor with values between 0 and 65535 (torch has no uint16 type). Otherwise they are
+            reduced to 8 bits. 8 bits images are always decoded to uint8 tensors. Default: False
+        skip_checksums (bool): if True, the CRC of the PNG chunks and the Adler-32 checksum of the
+            compressed stream are not verified. This speeds up decoding of trusted data, but a
+            corrupted image is then decoded to garbage rather than raising an error. Default: False
 
     Returns:
         output (Tensor[image_channels, image_height, image_width])
     """
-    output = torch.ops.image.decode_png(input, mode.value)
+    output = torch.ops.image.decode_png(input, mode.value, channels_last, allow_16_bits, skip_checksums)
     return output
 
 
-def encode_png(input: torch.Tensor, compression_level: int = 6) -> torch.Tensor:
+def encode_png(input: torch.Tensor, compression_level: int = 6, filter: str = "default",
+               strategy: str = "default", num_threads: int = 1) -> torch.Tensor:
     """
     Takes an input tensor in CHW layout and returns a buffer with the contents
     of its corresponding PNG file.
@@ -123,16 +143,27 @@ def encode_png(input: torch.Tensor, compression_level: int = 6) -> torch.Tensor:
             ``c`` channels, where ``c`` must 3 or 1.
         compression_level (int): Compression factor for the resulting file, it must be a number
             between 0 and 9. Default: 6
+        filter (str): the PNG row filter, one of ``"none"``, ``"sub"``, ``"up"``,
+            ``"avg"``, ``"paeth"``, or ``"adaptive"`` to pick the best one for
+            each row. ``"default"`` lets libpng choose. Default: ``"default"``
+        strategy (str): the zlib compression strategy, one of ``"filtered"``,
+            ``"huffman_only"``, ``"rle"`` or ``"fixed"``. ``"default"`` lets
+            libpng choose. Default: ``"default"``
+        num_threads (int): number of threads used to encode large images. If
+            different from 1, the image is split into bands of rows that are
+            filtered and compressed in parallel, which makes the file slightly
+            larger. If 0, ``torch.get_num_threads()`` threads are used. Default: 1
 
     Returns:
         Tensor[1]: A one dimensional int8 tensor that contains the raw bytes of the
             PNG file.
     """
-    output = torch.ops.image.encode_png(input, compression_level)
+    output = torch.ops.image.encode_png(input, compression_level, filter, strategy, num_threads)
     return output
 
 
-def write_png(input: torch.Tensor, filename: str, compression_level: int = 6):
+def write_png(input: torch.Tensor, filename: str, compression_level: int = 6, filter: str = "default",
+              strategy: str = "default", num_threads: int = 1):
     """
     Takes an input tensor in CHW layout (or HW in the case of grayscale images)
     and saves it in a PNG file.
@@ -143,13 +174,17 @@ def write_png(input: torch.Tensor, filename: str, compression_level: int = 6):
         filename (str): Path to save the image.
         compression_level (int): Compression factor for the resulting file, it must be a number
             between 0 and 9. Default: 6
+        filter (str): the PNG row filter, see :func:`encode_png`. Default: ``"default"``
+        strategy (str): the zlib compression strategy, see :func:`encode_png`. Default: ``"default"``
+        num_threads (int): number of encoding threads, see :func:`encode_png`. Default: 1
     """
-    output = encode_png(input, compression_level)
+    output = encode_png(input, compression_level, filter, strategy, num_threads)
     write_file(filename, output)
 
 
 def decode_jpeg(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED,
-                device: str = 'cpu') -> torch.Tensor:
+                device: str = 'cpu', min_size: Optional[Tuple[int, int]] = None,
+                channels_last: bool = True, max_scans: int = 0) -> torch.Tensor:
     """
     Decodes a JPEG image into a 3 dimensional RGB Tensor.
     Optionally converts the image to the desired format.
@@ -167,28 +202,117 @@ def decode_jpeg(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANG
             be stored. If a cuda device is specified, the image will be decoded
             with `nvjpeg <https://developer.nvidia.com/nvjpeg>`_. This is only
             supported for CUDA version >= 10.1
+        min_size (tuple of ints, optional): minimum (height, width) of the decoded
+            image. If given, the image is downscaled while being decoded, by the
+            largest of the factors 1/8, 2/8, ..., 8/8 that keeps the output at least
+            this large. This is much faster than decoding the full image and resizing it
+            afterwards. Only supported on CPU. Default: None
+        channels_last (bool): if True, the output is a view of an image stored in
+            ``[image_height, image_width, image_channels]`` (channels last) order, as
+            produced by the decoder. If False, the decoder writes a contiguous
+            tensor directly, which avoids a later ``.contiguous()`` copy. Only used on CPU: images decoded on
+            GPU are always contiguous. Default: True
+        max_scans (int): if positive, a progressive JPEG image is only decoded from its first
+            ``max_scans`` scans, and the remaining ones are not read at all. The output has the
+            full size but a lower quality, the first scan usually holding the DC coefficients only,
+            i.e. an 8x8 blocks preview. Combined with ``min_size``, this gives very fast previews.
+            Baseline (single scan) images are always fully decoded. Only supported on CPU.
+            Default: 0 (all the scans)
 
     Returns:
         output (Tensor[image_channels, image_height, image_width])
     """
     device = torch.device(device)
     if device.type == 'cuda':
+        if min_size is not None:
+            raise ValueError("min_size is only supported when decoding on CPU")
+        if max_scans != 0:
+            raise ValueError("max_scans is only supported when decoding on CPU")
         output = torch.ops.image.decode_jpeg_cuda(input, mode.value, device)
     else:
-        output = torch.ops.image.decode_jpeg(input, mode.value)
+        min_height, min_width = (0, 0) if min_size is None else min_size
+        output = torch.ops.image.decode_jpeg(input, mode.value, min_height, min_width, channels_last, max_scans)
     return output
 
 
-def encode_jpeg(input: torch.Tensor, quality: int = 75) -> torch.Tensor:
+def decode_jpeg_crop(input: torch.Tensor, top: int, left: int, height: int, width: int,
+                     mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                     min_size: Optional[Tuple[int, int]] = None, channels_last: bool = True) -> torch.Tensor:
+    """
+    Decodes the ``[top, top + height) x [left, left + width)`` region of a JPEG
+    image on CPU. This gives the same result as cropping the output of
+    :func:`decode_jpeg`, but with libjpeg-turbo only the parts of the image
+    that cover the region are decoded, which makes it a good fit for
+    :class:`~torchvision.transforms.RandomResizedCrop`-like pipelines.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the JPEG image.
+        top (int): vertical coordinate of the top left corner of the region.
+        left (int): horizontal coordinate of the top left corner of the region.
+        height (int): height of the region.
+        width (int): width of the region.
+        mode (ImageReadMode): the read mode used for optionally
+            converting the image. Default: ``ImageReadMode.UNCHANGED``.
+            See ``ImageReadMode`` class for more information on various
+            available modes.
+        min_size (tuple of ints, optional): minimum (height, width) of the decoded
+            region. If given, the region is downscaled while being decoded, as in
+            :func:`decode_jpeg`. Default: None
+        channels_last (bool): if True, the output is a view of an image stored in
+            ``[image_height, image_width, image_channels]`` (channels last) order, as
+            produced by the decoder. If False, the decoder writes a contiguous
+            tensor directly, which avoids a later ``.contiguous()`` copy. Default: True
+
+    Returns:
+        output (Tensor[image_channels, region_height, region_width])
+    """
+    min_height, min_width = (0, 0) if min_size is None else min_size
+    output = torch.ops.image.decode_jpeg_crop(
+        input, top, left, height, width, mode.value, min_height, min_width, channels_last
+    )
+    return output
+
+
+def decode_jpeg_raw(input: torch.Tensor) -> List[torch.Tensor]:
+    """
+    Decodes the components of a JPEG image as they are stored in the file,
+    usually the Y, Cb and Cr planes, on CPU. No upsampling nor color conversion
+    is performed: subsampled components keep their reduced size, e.g. Cb and
+    Cr are half the width and height of Y for a 4:2:0 image.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the JPEG image.
+
+    Returns:
+        planes (List[Tensor[plane_height, plane_width]]): one uint8 tensor per
+            component. Each is a view of a buffer padded to whole 8x8 blocks.
+    """
+    return torch.ops.image.decode_jpeg_raw(input)
+
+
+def encode_jpeg(input: torch.Tensor, quality: int = 75, dct_method: str = "islow", subsampling: str = "420",
+                optimize_coding: bool = False) -> torch.Tensor:
     """
     Takes an input tensor in CHW layout and returns a buffer with the contents
-    of its corresponding JPEG file.
+    of its corresponding JPEG file. The input is read in place whatever its
+    memory layout, so an HWC image can be passed as ``img.permute(2, 0, 1)``
+    without a copy.
 
     Args:
         input (Tensor[channels, image_height, image_width])): int8 image tensor of
             ``c`` channels, where ``c`` must be 1 or 3.
         quality (int): Quality of the resulting JPEG file, it must be a number between
             1 and 100. Default: 75
+        dct_method (str): the DCT implementation, one of ``"islow"`` (accurate
+            integer), ``"ifast"`` (faster and less accurate integer) or
+            ``"float"``. Default: ``"islow"``
+        subsampling (str): the chroma subsampling of 3 channels images, one of
+            ``"444"``, ``"422"``, ``"420"``, ``"440"`` or ``"411"``. Default: ``"420"``
+        optimize_coding (bool): whether to compute optimal Huffman tables for
+            the image, which makes the file smaller but the encoding slower.
+            Default: False
 
     Returns:
         output (Tensor[1]): A one dimensional int8 tensor that contains the raw bytes of the
@@ -198,11 +322,92 @@ def encode_jpeg(input: torch.Tensor, quality: int = 75) -> torch.Tensor:
         raise ValueError('Image quality should be a positive number '
                          'between 1 and 100')
 
-    output = torch.ops.image.encode_jpeg(input, quality)
+    output = torch.ops.image.encode_jpeg(input, quality, dct_method, subsampling, optimize_coding)
     return output
 
 
-def write_jpeg(input: torch.Tensor, filename: str, quality: int = 75):
+def encode_jpeg_batch(inputs: List[torch.Tensor], quality: int = 75, dct_method: str = "islow",
+                      subsampling: str = "420", optimize_coding: bool = False,
+                      num_threads: int = 0) -> Tuple[List[torch.Tensor], List[str]]:
+    """
+    Encodes a list of images as JPEG files on CPU, in parallel.
+    The images are encoded by a pool of ``num_threads`` threads that is
+    independent from ``torch.get_num_threads()``, and the GIL is released while
+    encoding. A failure to encode an image does not abort the whole batch: it is
+    reported in the list of errors instead.
+
+    Args:
+        inputs (List[Tensor[channels, image_height, image_width]]): int8 image
+            tensors of ``c`` channels, where ``c`` must be 1 or 3.
+        quality (int): Quality of the resulting JPEG files, it must be a number between
+            1 and 100. Default: 75
+        dct_method (str): see :func:`encode_jpeg`. Default: ``"islow"``
+        subsampling (str): see :func:`encode_jpeg`. Default: ``"420"``
+        optimize_coding (bool): see :func:`encode_jpeg`. Default: False
+        num_threads (int): number of encoding threads. If 0,
+            ``torch.get_num_threads()`` threads are used. Default: 0
+
+    Returns:
+        outputs (List[Tensor[1]]): the raw bytes of the JPEG files. Images that
+            could not be encoded yield empty tensors.
+        errors (List[str]): for each image, the encoding error message, or an
+            empty string if the image was encoded successfully.
+    """
+    if quality < 1 or quality > 100:
+        raise ValueError('Image quality should be a positive number '
+                         'between 1 and 100')
+
+    outputs, errors = torch.ops.image.encode_jpeg_batch(inputs, quality, dct_method, subsampling, optimize_coding,
+                                                        num_threads)
+    return outputs, errors
+
+
+def crop_jpeg(input: torch.Tensor, top: int, left: int, height: int, width: int) -> torch.Tensor:
+    """
+    Losslessly crops a JPEG image, without decoding nor re-compressing it: the
+    DCT coefficients of the blocks inside the region are copied to a new JPEG
+    file. The top left corner of the region is moved up and left to the nearest
+    iMCU boundary (a multiple of 8 or 16 pixels, depending on the chroma
+    subsampling), so the result may be slightly larger than the requested
+    region.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the JPEG image.
+        top (int): vertical coordinate of the top left corner of the region.
+        left (int): horizontal coordinate of the top left corner of the region.
+        height (int): height of the region.
+        width (int): width of the region.
+
+    Returns:
+        output (Tensor[1]): the raw bytes of the cropped JPEG file.
+    """
+    return torch.ops.image.crop_jpeg(input, top, left, height, width)
+
+
+def transform_jpeg(input: torch.Tensor, transform: str) -> torch.Tensor:
+    """
+    Losslessly flips or rotates a JPEG image in the DCT domain, as ``jpegtran``
+    does. This is exact and much faster than decoding, transforming and
+    re-encoding the image. A partial iMCU at the right or bottom edge can not
+    be moved to the opposite edge losslessly, so it is trimmed by the
+    transforms that would do so (e.g. the last ``width % 16`` columns of a 4:2:0
+    image are dropped by ``"hflip"``).
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the JPEG image.
+        transform (str): one of ``"hflip"``, ``"vflip"``, ``"transpose"``,
+            ``"rot90"``, ``"rot180"`` or ``"rot270"``. Rotations are clockwise.
+
+    Returns:
+        output (Tensor[1]): the raw bytes of the transformed JPEG file.
+    """
+    return torch.ops.image.transform_jpeg(input, transform)
+
+
+def write_jpeg(input: torch.Tensor, filename: str, quality: int = 75, dct_method: str = "islow",
+               subsampling: str = "420", optimize_coding: bool = False):
     """
     Takes an input tensor in CHW layout and saves it in a JPEG file.
 
@@ -212,12 +417,16 @@ def write_jpeg(input: torch.Tensor, filename: str, quality: int = 75):
         filename (str): Path to save the image.
         quality (int): Quality of the resulting JPEG file, it must be a number
             between 1 and 100. Default: 75
+        dct_method (str): see :func:`encode_jpeg`. Default: ``"islow"``
+        subsampling (str): see :func:`encode_jpeg`. Default: ``"420"``
+        optimize_coding (bool): see :func:`encode_jpeg`. Default: False
     """
-    output = encode_jpeg(input, quality)
+    output = encode_jpeg(input, quality, dct_method, subsampling, optimize_coding)
     write_file(filename, output)
 
 
-def decode_image(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torch.Tensor:
+def decode_image(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                 channels_last: bool = True) -> torch.Tensor:
     """
     Detects whether an image is a JPEG or PNG and performs the appropriate
     operation to decode the image into a 3 dimensional RGB Tensor.
@@ -232,15 +441,223 @@ def decode_image(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHAN
             Default: ``ImageReadMode.UNCHANGED``.
             See ``ImageReadMode`` class for more information on various
             available modes.
+        channels_last (bool): if True, the output is a view of an image stored in
+            ``[image_height, image_width, image_channels]`` (channels last) order, as
+            produced by the decoder. If False, the decoder writes a contiguous
+            tensor directly, which avoids a later ``.contiguous()`` copy. Default: True
 
     Returns:
         output (Tensor[image_channels, image_height, image_width])
     """
-    output = torch.ops.image.decode_image(input, mode.value)
+    output = torch.ops.image.decode_image(input, mode.value, channels_last)
     return output
 
 
-def read_image(path: str, mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torch.Tensor:
+def decode_jpeg_batch(inputs: List[torch.Tensor], mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                      num_threads: int = 0) -> Tuple[List[torch.Tensor], List[str]]:
+    """
+    Decodes a list of JPEG images on CPU, in parallel.
+    The images are decoded by a pool of ``num_threads`` threads that is
+    independent from ``torch.get_num_threads()``, and the GIL is released while
+    decoding. A failure to decode an image does not abort the whole batch: it is
+    reported in the list of errors instead.
+
+    Args:
+        inputs (List[Tensor[1]]): one dimensional uint8 tensors containing
+            the raw bytes of the JPEG images.
+        mode (ImageReadMode): the read mode used for optionally
+            converting the images. Default: ``ImageReadMode.UNCHANGED``.
+            See ``ImageReadMode`` class for more information on various
+            available modes.
+        num_threads (int): number of decoding threads. If 0,
+            ``torch.get_num_threads()`` threads are used. Default: 0
+
+    Returns:
+        images (List[Tensor[image_channels, image_height, image_width]]): the
+            decoded images. Images that could not be decoded are empty tensors.
+        errors (List[str]): for each image, the decoding error message, or an
+            empty string if the image was decoded successfully.
+    """
+    images, errors = torch.ops.image.decode_jpeg_batch(inputs, mode.value, num_threads)
+    return images, errors
+
+
+def decode_image_batch(inputs: List[torch.Tensor], mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                       num_threads: int = 0) -> Tuple[List[torch.Tensor], List[str]]:
+    """
+    Same as :func:`decode_jpeg_batch`, but each image may either be a JPEG or a
+    PNG image, as in :func:`decode_image`.
+
+    Args:
+        inputs (List[Tensor[1]]): one dimensional uint8 tensors containing
+            the raw bytes of the PNG or JPEG images.
+        mode (ImageReadMode): the read mode used for optionally converting the images.
+            Default: ``ImageReadMode.UNCHANGED``.
+            See ``ImageReadMode`` class for more information on various
+            available modes.
+        num_threads (int): number of decoding threads. If 0,
+            ``torch.get_num_threads()`` threads are used. Default: 0
+
+    Returns:
+        images (List[Tensor[image_channels, image_height, image_width]]): the
+            decoded images. Images that could not be decoded are empty tensors.
+        errors (List[str]): for each image, the decoding error message, or an
+            empty string if the image was decoded successfully.
+    """
+    images, errors = torch.ops.image.decode_image_batch(inputs, mode.value, num_threads)
+    return images, errors
+
+
+def get_decoded_shape(input: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                      min_size: Optional[Tuple[int, int]] = None) -> List[int]:
+    """
+    Returns the shape of the tensor that decoding a JPEG or PNG image would
+    produce, by only reading its headers. Together with
+    :func:`decode_image_out`, this allows decoding images straight into a
+    preallocated buffer, e.g. a slot of a pinned memory batch.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing the raw bytes
+            of the PNG or JPEG image.
+        mode (ImageReadMode): the read mode the image will be decoded with.
+            Default: ``ImageReadMode.UNCHANGED``.
+        min_size (tuple of ints, optional): the ``min_size`` a JPEG image will be
+            decoded with, see :func:`decode_jpeg`. Ignored for PNG images. Default: None
+
+    Returns:
+        shape (List[int]): ``[image_channels, image_height, image_width]``
+    """
+    min_height, min_width = (0, 0) if min_size is None else min_size
+    return torch.ops.image.get_decoded_shape(input, mode.value, min_height, min_width)
+
+
+def decode_jpeg_out(input: torch.Tensor, out: torch.Tensor, mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                    min_size: Optional[Tuple[int, int]] = None) -> torch.Tensor:
+    """
+    Same as :func:`decode_jpeg` on CPU, but writes the image into ``out``
+    instead of allocating a new tensor.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the JPEG image.
+        out (Tensor[image_channels, image_height, image_width]): uint8 tensor
+            receiving the image, either contiguous or channels last. Its shape
+            is given by :func:`get_decoded_shape`.
+        mode (ImageReadMode): the read mode used for optionally
+            converting the image. Default: ``ImageReadMode.UNCHANGED``.
+        min_size (tuple of ints, optional): see :func:`decode_jpeg`. Default: None
+
+    Returns:
+        out (Tensor[image_channels, image_height, image_width])
+    """
+    min_height, min_width = (0, 0) if min_size is None else min_size
+    return torch.ops.image.decode_jpeg_out(input, out, mode.value, min_height, min_width)
+
+
+def decode_png_out(input: torch.Tensor, out: torch.Tensor,
+                   mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torch.Tensor:
+    """
+    Same as :func:`decode_png`, but writes the image into ``out`` instead of
+    allocating a new tensor.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing
+            the raw bytes of the PNG image.
+        out (Tensor[image_channels, image_height, image_width]): uint8 tensor
+            receiving the image, either contiguous or channels last. Its shape
+            is given by :func:`get_decoded_shape`.
+        mode (ImageReadMode): the read mode used for optionally
+            converting the image. Default: ``ImageReadMode.UNCHANGED``.
+
+    Returns:
+        out (Tensor[image_channels, image_height, image_width])
+    """
+    return torch.ops.image.decode_png_out(input, out, mode.value)
+
+
+def decode_image_out(input: torch.Tensor, out: torch.Tensor,
+                     mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torch.Tensor:
+    """
+    Same as :func:`decode_image`, but writes the image into ``out`` instead of
+    allocating a new tensor.
+
+    Example:
+        >>> shapes = [get_decoded_shape(data) for data in encoded_images]
+        >>> batch = torch.empty((len(shapes), *shapes[0]), dtype=torch.uint8).pin_memory()
+        >>> for data, slot in zip(encoded_images, batch):
+        >>>     decode_image_out(data, slot)
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing the raw bytes
+            of the PNG or JPEG image.
+        out (Tensor[image_channels, image_height, image_width]): uint8 tensor
+            receiving the image, either contiguous or channels last. Its shape
+            is given by :func:`get_decoded_shape`.
+        mode (ImageReadMode): the read mode used for optionally converting the image.
+            Default: ``ImageReadMode.UNCHANGED``.
+
+    Returns:
+        out (Tensor[image_channels, image_height, image_width])
+    """
+    return torch.ops.image.decode_image_out(input, out, mode.value)
+
+
+class ImageInfo(NamedTuple):
+    """
+    Metadata of an encoded image, as returned by :func:`probe_image`.
+    ``num_channels`` is the number of channels the image is decoded with
+    ``ImageReadMode.UNCHANGED``, ``orientation`` is its EXIF orientation tag
+    (1 when the image has none).
+    """
+    height: int
+    width: int
+    num_channels: int
+    bit_depth: int
+    progressive: bool
+    interlaced: bool
+    orientation: int
+
+
+def probe_image(input: torch.Tensor) -> ImageInfo:
+    """
+    Reads the metadata of a JPEG or PNG image from its headers only, without
+    decoding any pixel. This is much cheaper than :func:`decode_image` and can
+    be used to filter or bucket images by size before decoding them.
+
+    Args:
+        input (Tensor[1]): a one dimensional uint8 tensor containing the raw bytes
+            of the PNG or JPEG image.
+
+    Returns:
+        info (ImageInfo)
+    """
+    info = torch.ops.image.probe_image(input).tolist()
+    return ImageInfo(info[0], info[1], info[2], info[3], bool(info[4]), bool(info[5]), info[6])
+
+
+def probe_image_batch(inputs: List[torch.Tensor], num_threads: int = 0) -> Tuple[torch.Tensor, List[str]]:
+    """
+    Same as :func:`probe_image` for a list of images, probed in parallel.
+
+    Args:
+        inputs (List[Tensor[1]]): one dimensional uint8 tensors containing
+            the raw bytes of the PNG or JPEG images.
+        num_threads (int): number of threads. If 0, ``torch.get_num_threads()``
+            threads are used. Default: 0
+
+    Returns:
+        info (Tensor[N, 7]): int64 tensor whose columns are the fields of
+            :class:`ImageInfo`, in order: height, width, num_channels,
+            bit_depth, progressive, interlaced and orientation. The row of an
+            image that could not be probed is filled with -1.
+        errors (List[str]): for each image, the error message, or an empty
+            string if the image was probed successfully.
+    """
+    info, errors = torch.ops.image.probe_image_batch(inputs, num_threads)
+    return info, errors
+
+
+def read_image(path: str, mode: ImageReadMode = ImageReadMode.UNCHANGED, mmap: bool = False) -> torch.Tensor:
     """
     Reads a JPEG or PNG image into a 3 dimensional RGB Tensor.
     Optionally converts the image to the desired format.
@@ -252,9 +669,40 @@ def read_image(path: str, mode: ImageReadMode = ImageReadMode.UNCHANGED) -> torc
             Default: ``ImageReadMode.UNCHANGED``.
             See ``ImageReadMode`` class for more information on various
             available modes.
+        mmap (bool): if True, the file is memory mapped and decoded in place, without
+            being copied into a buffer first. The file must not be truncated while it
+            is read, see :func:`read_file`. Default: False
 
     Returns:
         output (Tensor[image_channels, image_height, image_width])
     """
-    data = read_file(path)
-    return decode_image(data, mode)
+    if not mmap:
+        data = read_file(path)
+        return decode_image(data, mode)
+    return torch.ops.image.decode_image_from_file(path, mode.value, mmap)
+
+
+def read_image_batch(paths: List[str], mode: ImageReadMode = ImageReadMode.UNCHANGED,
+                     num_threads: int = 0, mmap: bool = False) -> Tuple[List[torch.Tensor], List[str]]:
+    """
+    Same as :func:`decode_image_batch`, for images read from files: each
+    image is read and decoded as in :func:`read_image`, on a pool of
+    ``num_threads`` threads.
+
+    Args:
+        paths (List[str]): paths of the JPEG or PNG images.
+        mode (ImageReadMode): the read mode used for optionally converting the images.
+            Default: ``ImageReadMode.UNCHANGED``.
+        num_threads (int): number of threads. If 0, ``torch.get_num_threads()``
+            threads are used. Default: 0
+        mmap (bool): if True, the files are memory mapped, as in :func:`read_image`.
+            Default: False
+
+    Returns:
+        images (List[Tensor[image_channels, image_height, image_width]]): the
+            decoded images. Images that could not be read or decoded are empty tensors.
+        errors (List[str]): for each image, the error message, or an empty
+            string if the image was read successfully.
+    """
+    images, errors = torch.ops.image.decode_image_from_file_batch(paths, mode.value, num_threads, mmap)
+    return images, errors
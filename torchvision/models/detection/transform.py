@@ -23,6 +23,18 @@ def _fake_cast_onnx(v):
     return v
 
 
+def _get_resized_size(image: Tensor, self_min_size: float, self_max_size: float,
+                      fixed_size: Optional[Tuple[int, int]] = None) -> List[int]:
+    if fixed_size is not None:
+        return [fixed_size[1], fixed_size[0]]
+    im_shape = torch.tensor(image.shape[-2:])
+    min_size = torch.min(im_shape).to(dtype=torch.float32)
+    max_size = torch.max(im_shape).to(dtype=torch.float32)
+    scale = float(torch.min(self_min_size / min_size, self_max_size / max_size).item())
+    # same rounding as interpolate() with recompute_scale_factor=True
+    return [int(math.floor(float(s) * scale)) for s in image.shape[-2:]]
+
+
 def _resize_image_and_masks(image: Tensor, self_min_size: float, self_max_size: float,
                             target: Optional[Dict[str, Tensor]] = None,
                             fixed_size: Optional[Tuple[int, int]] = None,
@@ -62,6 +74,19 @@ def _resize_image_and_masks(image: Tensor, self_min_size: float, self_max_size:
     return image, target
 
 
+def _resize_boxes_and_keypoints(target, original_size, new_size):
+    # type: (Dict[str, Tensor], List[int], List[int]) -> Dict[str, Tensor]
+    bbox = target["boxes"]
+    bbox = resize_boxes(bbox, original_size, new_size)
+    target["boxes"] = bbox
+
+    if "keypoints" in target:
+        keypoints = target["keypoints"]
+        keypoints = resize_keypoints(keypoints, original_size, new_size)
+        target["keypoints"] = keypoints
+    return target
+
+
 class GeneralizedRCNNTransform(nn.Module):
     """
     Performs input / target transformation before feeding the data to a GeneralizedRCNN
@@ -72,9 +97,13 @@ class GeneralizedRCNNTransform(nn.Module):
         - input / target resizing to match min_size / max_size
 
     It returns a ImageList for the inputs, and a List[Dict[Tensor]] for the targets
+
+    With ``batched_resize=True``, CPU inputs are resized directly into the padded batch by a
+    single native op, instead of going through :meth:`resize` and :meth:`batch_images`.
     """
 
-    def __init__(self, min_size, max_size, image_mean, image_std, size_divisible=32, fixed_size=None):
+    def __init__(self, min_size, max_size, image_mean, image_std, size_divisible=32, fixed_size=None,
+                 batched_resize=False):
         super(GeneralizedRCNNTransform, self).__init__()
         if not isinstance(min_size, (list, tuple)):
             min_size = (min_size,)
@@ -84,6 +113,7 @@ class GeneralizedRCNNTransform(nn.Module):
         self.image_std = image_std
         self.size_divisible = size_divisible
         self.fixed_size = fixed_size
+        self.batched_resize = batched_resize
 
     def forward(self,
                 images,       # type: List[Tensor]
@@ -103,6 +133,8 @@ class GeneralizedRCNNTransform(nn.Module):
                     data[k] = v
                 targets_copy.append(data)
             targets = targets_copy
+        batched_resize = self._use_batched_resize(images)
+        new_sizes: List[int] = []
         for i in range(len(images)):
             image = images[i]
             target_index = targets[i] if targets is not None else None
@@ -111,11 +143,25 @@ class GeneralizedRCNNTransform(nn.Module):
                 raise ValueError("images is expected to be a list of 3d tensors "
                                  "of shape [C, H, W], got {}".format(image.shape))
             image = self.normalize(image)
-            image, target_index = self.resize(image, target_index)
+            if batched_resize:
+                # images are resized all at once below, directly into the padded batch
+                new_size = _get_resized_size(image, self._get_min_size(), float(self.max_size), self.fixed_size)
+                target_index = self.resize_target(target_index, image.shape[-2:], new_size)
+                new_sizes.extend(new_size)
+            else:
+                image, target_index = self.resize(image, target_index)
             images[i] = image
             if targets is not None and target_index is not None:
                 targets[i] = target_index
 
+        if batched_resize:
+            batched_imgs, _ = torch.ops.torchvision._resize_pad_batch(
+                images, new_sizes, "bilinear", False, self.size_divisible, False)
+            batched_sizes_list: List[Tuple[int, int]] = []
+            for j in range(len(images)):
+                batched_sizes_list.append((new_sizes[2 * j], new_sizes[2 * j + 1]))
+            return ImageList(batched_imgs, batched_sizes_list), targets
+
         image_sizes = [img.shape[-2:] for img in images]
         images = self.batch_images(images, size_divisible=self.size_divisible)
         image_sizes_list: List[Tuple[int, int]] = []
@@ -147,29 +193,47 @@ class GeneralizedRCNNTransform(nn.Module):
         index = int(torch.empty(1).uniform_(0., float(len(k))).item())
         return k[index]
 
+    def _get_min_size(self) -> float:
+        if self.training:
+            return float(self.torch_choice(self.min_size))
+        # FIXME assume for now that testing uses the largest scale
+        return float(self.min_size[-1])
+
+    def _use_batched_resize(self, images: List[Tensor]) -> bool:
+        # The batched resize op only has a CPU kernel and does not export to ONNX
+        if not self.batched_resize or torchvision._is_tracing() or len(images) == 0:
+            return False
+        for img in images:
+            if img.device.type != "cpu":
+                return False
+        return True
+
+    def resize_target(self,
+                      target: Optional[Dict[str, Tensor]],
+                      original_size: List[int],
+                      new_size: List[int],
+                      ) -> Optional[Dict[str, Tensor]]:
+        if target is None:
+            return target
+
+        if "masks" in target:
+            mask = target["masks"]
+            mask = torch.nn.functional.interpolate(mask[:, None].float(), size=new_size)[:, 0].byte()
+            target["masks"] = mask
+        return _resize_boxes_and_keypoints(target, original_size, new_size)
+
     def resize(self,
                image: Tensor,
                target: Optional[Dict[str, Tensor]] = None,
                ) -> Tuple[Tensor, Optional[Dict[str, Tensor]]]:
         h, w = image.shape[-2:]
-        if self.training:
-            size = float(self.torch_choice(self.min_size))
-        else:
-            # FIXME assume for now that testing uses the largest scale
-            size = float(self.min_size[-1])
+        size = self._get_min_size()
         image, target = _resize_image_and_masks(image, size, float(self.max_size), target, self.fixed_size)
 
         if target is None:
             return image, target
 
-        bbox = target["boxes"]
-        bbox = resize_boxes(bbox, (h, w), image.shape[-2:])
-        target["boxes"] = bbox
-
-        if "keypoints" in target:
-            keypoints = target["keypoints"]
-            keypoints = resize_keypoints(keypoints, (h, w), image.shape[-2:])
-            target["keypoints"] = keypoints
+        target = _resize_boxes_and_keypoints(target, [h, w], image.shape[-2:])
         return image, target
 
     # _onnx_batch_images() is an implementation of
@@ -361,7 +361,9 @@ def resize(img: Tensor, size: List[int], interpolation: InterpolationMode = Inte
         interpolation (InterpolationMode): Desired interpolation enum defined by
             :class:`torchvision.transforms.InterpolationMode`.
             Default is ``InterpolationMode.BILINEAR``. If input is Tensor, only ``InterpolationMode.NEAREST``,
-            ``InterpolationMode.BILINEAR`` and ``InterpolationMode.BICUBIC`` are supported.
+            ``InterpolationMode.BILINEAR`` and ``InterpolationMode.BICUBIC`` are supported, as well as
+            ``InterpolationMode.BOX``, ``InterpolationMode.HAMMING`` and ``InterpolationMode.LANCZOS`` with
+            ``antialias=True``.
             For backward compatibility integer values (e.g. ``PIL.Image.NEAREST``) are still acceptable.
         max_size (int, optional): The maximum allowed for the longer edge of
             the resized image: if the longer edge of the image is greater
@@ -373,10 +375,12 @@ def resize(img: Tensor, size: List[int], interpolation: InterpolationMode = Inte
             mode).
         antialias (bool, optional): antialias flag. If ``img`` is PIL Image, the flag is ignored and anti-alias
             is always used. If ``img`` is Tensor, the flag is False by default and can be set True for
-            ``InterpolationMode.BILINEAR`` only mode.
+            ``InterpolationMode.BILINEAR``, ``InterpolationMode.BICUBIC``, ``InterpolationMode.BOX``,
+            ``InterpolationMode.HAMMING`` and ``InterpolationMode.LANCZOS`` modes. The last three are only
+            supported on CPU.
 
             .. warning::
-                There is no autodiff support for ``antialias=True`` option with input ``img`` as Tensor.
+                Autodiff for ``antialias=True`` option with input ``img`` as Tensor is only supported on CPU.
 
     Returns:
         PIL Image or Tensor: Resized image.
@@ -491,7 +491,7 @@ def resize(
     if not isinstance(interpolation, str):
         raise TypeError("Got inappropriate interpolation arg")
 
-    if interpolation not in ["nearest", "bilinear", "bicubic"]:
+    if interpolation not in ["nearest", "bilinear", "bicubic", "box", "hamming", "lanczos"]:
         raise ValueError("This interpolation mode is unsupported with Tensor input")
 
     if isinstance(size, tuple):
@@ -510,8 +510,13 @@ def resize(
     if antialias is None:
         antialias = False
 
-    if antialias and interpolation not in ["bilinear", "bicubic"]:
-        raise ValueError("Antialias option is supported for bilinear and bicubic interpolation modes only")
+    if antialias and interpolation not in ["bilinear", "bicubic", "box", "hamming", "lanczos"]:
+        raise ValueError(
+            "Antialias option is supported for bilinear, bicubic, box, hamming and lanczos interpolation modes only"
+        )
+
+    if not antialias and interpolation in ["box", "hamming", "lanczos"]:
+        raise ValueError("Box, hamming and lanczos interpolation modes are only supported with antialias=True")
 
     w, h = _get_image_size(img)
 
@@ -548,10 +553,16 @@ def resize(
             img = torch.ops.torchvision._interpolate_linear_aa(img, [new_h, new_w], align_corners=False)
         elif interpolation == "bicubic":
             img = torch.ops.torchvision._interpolate_bicubic_aa(img, [new_h, new_w], align_corners=False)
+        elif interpolation == "box":
+            img = torch.ops.torchvision._interpolate_box_aa(img, [new_h, new_w], align_corners=False)
+        elif interpolation == "hamming":
+            img = torch.ops.torchvision._interpolate_hamming_aa(img, [new_h, new_w], align_corners=False)
+        elif interpolation == "lanczos":
+            img = torch.ops.torchvision._interpolate_lanczos_aa(img, [new_h, new_w], align_corners=False)
     else:
         img = interpolate(img, size=[new_h, new_w], mode=interpolation, align_corners=align_corners)
 
-    if interpolation == "bicubic" and out_dtype == torch.uint8:
+    if interpolation in ["bicubic", "hamming", "lanczos"] and out_dtype == torch.uint8:
         img = img.clamp(min=0, max=255)
 
     img = _cast_squeeze_out(img, need_cast=need_cast, need_squeeze=need_squeeze, out_dtype=out_dtype)